@@ -9,19 +9,30 @@
 
 #include "ABacktrace_MazeGen.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "MazeFileIO.h"
+#include "MazeGenStats.h"
+#include "MazeMeshComponents.h"
+#include "Async/Async.h"
+
+#include <algorithm>
+
+// Seed salt for the stream of shift seeds and random shift regions
+static const uint64 BacktraceShiftSalt = 0x53686966745265ull;
 
 /*===================
 AABacktrace_MazeGen 
 
 Constructor
 Initializes the actor with static mesh components for the floor and walls.
-Enables Tick() to run every frame.
+Tick only runs while wall edits wait to be flushed or regions are shifting, after the rest of the frame's updates.
 ===================*/
 AABacktrace_MazeGen::AABacktrace_MazeGen()
 {
 
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	// Tick is switched on by wall edits and shifts, and off again once they are done
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
 
 	// Create and set Root Component if not already set
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
@@ -44,21 +55,31 @@ AABacktrace_MazeGen::AABacktrace_MazeGen()
 }
 
 /*===================
-GenerateMazeMeshes
+SetupMeshComponents
 
-Sets up the maze meshes and materials for the maze generation process.
-It assigns static meshes to floor and wall components and creates dynamic materials for instancing.
-The maze grid is initialized with random rotations, and the maze is generated with a start and end point.
-The start and end points are assigned openings in the walls, and the maze is visualized using the `VisualiseMaze` function.
-Validations are performed to ensure components are correctly initialized before proceeding.
+Assigns static meshes to the floor and wall components and creates dynamic materials for instancing.
+Returns false if the components are not correctly initialized.
 ===================*/
-void AABacktrace_MazeGen::GenerateMazeMeshes()
+bool AABacktrace_MazeGen::SetupMeshComponents()
 {
 	// Ensure components are valid before proceeding
 	if (!m_floorStaticMeshComponent || !m_defaultWallStaticMeshComponent || !m_rotatedWallStaticMeshComponent)
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, TEXT("Failed: One or more static mesh components are null!"));
-		return;
+		return false;
+	}
+
+	// Swap in hierarchical components if requested and apply the cull distance
+	for (UInstancedStaticMeshComponent** component : { &m_floorStaticMeshComponent, &m_defaultWallStaticMeshComponent, &m_rotatedWallStaticMeshComponent }) {
+		FMazeMeshComponents::SetHierarchical(this, *component, bUseHierarchicalInstancing);
+		FMazeMeshComponents::SetCullDistance(*component, instanceCullDistance);
+	}
+
+	// Static components cannot have their instances changed at runtime
+	if (bEnableWallEdits)
+	{
+		m_defaultWallStaticMeshComponent->SetMobility(EComponentMobility::Movable);
+		m_rotatedWallStaticMeshComponent->SetMobility(EComponentMobility::Movable);
 	}
 
 	// Assign Static Meshes
@@ -94,195 +115,624 @@ void AABacktrace_MazeGen::GenerateMazeMeshes()
 		m_rotatedWallStaticMeshComponent->SetMaterial(0, m_rotatedWallInstancedMaterial);
 	}
 
+	return true;
+}
 
-	/*NEW*/
-	// Step 1: Init maze with random rotations
-
-	grid.SetNum(levelWidth);
-	for (int x = 0; x < levelWidth; x++) {
-		grid[x].SetNum(levelHeight);
-	}
+/*===================
+GenerateMazeMeshes
 
-	// Step 2: Generate the maze
-	int startX = 0;
-	int startY = 0;
+Sets up the maze meshes and materials, picks the seed, generates the maze with its entrance
+and exit openings, and visualizes it using the `VisualiseMaze` function.
+With bGenerateAsync set, generation and transform building move to a worker thread instead.
+Every stage is timed into the returned summary.
+===================*/
+const FMazeGenerationSummary& AABacktrace_MazeGen::GenerateMazeMeshes()
+{
+	MAZEGEN_SCOPE(STAT_MazeGen_GenerateMeshes);
 
-	// Randomly choose the end point on the right or top edge
-	int endX, endY;
-	bool isRightEdge = FMath::RandBool(); // 50/50 chance for right or top edge
-	if (isRightEdge) {
-		endX = levelWidth - 1; // Right edge
-		endY = FMath::RandRange(0, levelHeight - 1);
+	// A maze file replaces generation entirely
+	if (!mazeFile.FilePath.IsEmpty())
+	{
+		if (ImportMaze(mazeFile.FilePath)) {
+			return m_summary;
+		}
+		UE_LOG(LogTemp, Warning, TEXT("Could not load maze file %s, generating a maze instead"), *mazeFile.FilePath);
 	}
-	else {
-		endX = FMath::RandRange(0, levelWidth - 1); // Top edge
-		endY = levelHeight - 1;
+
+	if (!SetupMeshComponents())
+	{
+		return m_summary;
 	}
-	GenerateMaze(startX, startY);
 
-	// Step 4: Create openings at start and end
-	grid[startX][startY].westWall = false; // Entrance opening at (0,0) on the left side
+	/*NEW*/
+	// Step 1: Pick the seed. Everything below is determined by it.
+	if (bRandomizeSeed) {
+		seed = (int64(FMath::Rand()) << 32) ^ int64(FPlatformTime::Cycles64());
+	}
+	BeginSummary(bGenerateAsync);
 
-	// Remove the appropriate wall at the end point
-	if (isRightEdge) {
-		grid[endX][endY].eastWall = false; // Exit opening on the right side
+	if (bGenerateAsync) {
+		GenerateMazeMeshesAsync();
+		return m_summary;
 	}
-	else {
-		grid[endX][endY].northWall = false; // Exit opening on the top side
+
+	// A maze seen before with the same settings comes from the cache, transforms and all
+	if (bUseGenerationCache && !bRandomizeSeed)
+	{
+		const MazeCore::FMazeLayoutSettings settings = GetLayoutSettings();
+		const FMazeGenCacheEntryPtr cached = FindOrGenerateMaze(FMazeGenCacheKey::MakeBacktrace(static_cast<MazeCore::EMazeGenAlgorithm>(algorithm),
+			uint64(seed), levelWidth, levelHeight, settings), settings, m_summary);
+		grid = cached->grid;
+		m_endpoints = cached->endpoints;
+		InitSolvers();
+		VisualiseMaze(cached->instances);
+		OnMazeGenerated.Broadcast();
+		return m_summary;
 	}
 
+	// Step 2: Init the grid, generate the maze from the entrance and open the entrance and exit
+	m_endpoints = GenerateGrid(grid, levelWidth, levelHeight, static_cast<MazeCore::EMazeGenAlgorithm>(algorithm), uint64(seed), m_summary);
+	InitSolvers();
+
 	// Step 3: Visualize it
 	VisualiseMaze();
 
+	OnMazeGenerated.Broadcast();
+	return m_summary;
+}
+
+/*===================
+GenerateMazeMeshesAsync
+
+Generates the grid and builds the solvers and all instance transforms on a background thread,
+then hands the result back to the game thread, which only moves the grid and solvers in and adds
+the instances.
+A shared cancellation flag lets CancelGeneration (or EndPlay) abandon the work at any stage.
+===================*/
+void AABacktrace_MazeGen::GenerateMazeMeshesAsync()
+{
+	// A new generation supersedes any that is still running
+	CancelGeneration();
+
+	TSharedPtr<MazeCore::FMazeCancelFlag, ESPMode::ThreadSafe> cancelToken = MakeShared<MazeCore::FMazeCancelFlag, ESPMode::ThreadSafe>(false);
+	m_cancelToken = cancelToken;
+
+	// Capture everything the worker needs by value; it must not touch the actor
+	TWeakObjectPtr<AABacktrace_MazeGen> weakThis(this);
+	const int32 width = levelWidth;
+	const int32 height = levelHeight;
+	const MazeCore::EMazeGenAlgorithm mazeAlgorithm = static_cast<MazeCore::EMazeGenAlgorithm>(algorithm);
+	const uint64 mazeSeed = uint64(seed);
+	const MazeCore::FMazeLayoutSettings settings = GetLayoutSettings();
+	const bool bUseCache = bUseGenerationCache && !bRandomizeSeed;
+	const bool bBuildIndex = bBuildDistanceIndex;
+	const bool bBuildGraph = bUseCorridorGraph;
+	const FMazeGenerationSummary summary = m_summary;
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [weakThis, cancelToken, width, height, mazeAlgorithm, mazeSeed, settings, bUseCache, bBuildIndex, bBuildGraph,
+		summary]()
+	{
+		// Cached transforms are shared with the cache rather than copied. The solvers read result's grid
+		// until the game thread moves both into the actor.
+		struct FResult
+		{
+			MazeCore::FMazeGrid grid;
+			MazeCore::FMazeEndpoints endpoints;
+			MazeCore::FMazeSolver solver;
+			MazeCore::FMazeSolver exitSolver;
+			MazeCore::FMazeFlowField flowField;
+			MazeCore::FMazeTreeIndex treeIndex;
+			MazeCore::FMazeCorridorGraph corridorGraph;
+			FMazeInstanceBuffers instances;
+			FMazeGenCacheEntryPtr cached;
+			FMazeGenerationSummary summary;
+		};
+		TSharedPtr<FResult, ESPMode::ThreadSafe> result = MakeShared<FResult, ESPMode::ThreadSafe>();
+		result->summary = summary;
+
+		if (bUseCache)
+		{
+			result->cached = FindOrGenerateMaze(FMazeGenCacheKey::MakeBacktrace(mazeAlgorithm, mazeSeed, width, height, settings), settings, result->summary,
+				cancelToken.Get());
+			if (!result->cached.IsValid() || cancelToken->load()) {
+				return;
+			}
+			// The actor's grid can change later, so it gets its own copy
+			result->grid = result->cached->grid;
+			result->endpoints = result->cached->endpoints;
+		}
+		else
+		{
+			result->endpoints = GenerateGrid(result->grid, width, height, mazeAlgorithm, mazeSeed, result->summary, cancelToken.Get());
+			if (cancelToken->load()) {
+				return;
+			}
+
+			BuildInstanceBuffers(result->grid, settings, result->instances, result->summary);
+			if (cancelToken->load()) {
+				return;
+			}
+		}
+
+		BuildSolvers(result->grid, result->endpoints, bBuildIndex, bBuildGraph, result->solver, result->exitSolver, result->flowField, result->treeIndex,
+			result->corridorGraph, result->summary);
+		if (cancelToken->load()) {
+			return;
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [weakThis, cancelToken, result]()
+		{
+			AABacktrace_MazeGen* maze = weakThis.Get();
+			if (!maze || cancelToken->load()) {
+				return;
+			}
+
+			maze->grid = MoveTemp(result->grid);
+			maze->m_endpoints = result->endpoints;
+			maze->m_summary = result->summary;
+			maze->m_solver = MoveTemp(result->solver);
+			maze->m_exitSolver = MoveTemp(result->exitSolver);
+			maze->m_flowField = MoveTemp(result->flowField);
+			maze->m_treeIndex = MoveTemp(result->treeIndex);
+			maze->m_corridorGraph = MoveTemp(result->corridorGraph);
+			maze->RebindSolvers();
+			const FMazeInstanceBuffers& instances = result->cached.IsValid() ? result->cached->instances : result->instances;
+			{
+				MAZEGEN_STAGE_SCOPE(STAT_MazeGen_AddInstances, maze->m_summary.addInstancesMs);
+				FMazeInstanceBuffers::ClearFrom(maze->m_floorStaticMeshComponent, maze->m_defaultWallStaticMeshComponent, maze->m_rotatedWallStaticMeshComponent);
+				instances.AddTo(maze->m_floorStaticMeshComponent, maze->m_defaultWallStaticMeshComponent, maze->m_rotatedWallStaticMeshComponent);
+			}
+			maze->InitWallEdits();
+			maze->FinishSummary(instances);
+			maze->m_cancelToken.Reset();
+			maze->OnMazeGenerated.Broadcast();
+		});
+	});
 }
 
+void AABacktrace_MazeGen::CancelGeneration()
+{
+	if (m_cancelToken.IsValid()) {
+		m_cancelToken->store(true);
+		m_cancelToken.Reset();
+	}
+}
+
+MazeCore::FMazeLayoutSettings AABacktrace_MazeGen::GetLayoutSettings() const
+{
+	MazeCore::FMazeLayoutSettings settings;
+	settings.positionScaling = positionScaling;
+	settings.meshScaleX = meshScaling.X;
+	settings.meshScaleY = meshScaling.Y;
+	settings.meshScaleZ = meshScaling.Z;
+	settings.zOffset = zOffset;
+	settings.bMergeWalls = bMergeWalls;
+	settings.floorLayout = static_cast<MazeCore::EMazeFloorLayout>(floorMode);
+	return settings;
+}
+
+/*===================
+GenerateGrid
+
+The steps of MazeCore::GenerateMazeFromSeed, with the grid allocation timed on its own
+===================*/
+MazeCore::FMazeEndpoints AABacktrace_MazeGen::GenerateGrid(MazeCore::FMazeGrid& mazeGrid, int32 width, int32 height, MazeCore::EMazeGenAlgorithm mazeAlgorithm,
+	uint64 mazeSeed, FMazeGenerationSummary& summary, const MazeCore::FMazeCancelFlag* cancel)
+{
+	MazeCore::FMazeRandom random(mazeSeed);
+	{
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_AllocateGrid, summary.allocateMs);
+		mazeGrid.Init(width, height);
+	}
+
+	MAZEGEN_STAGE_SCOPE(STAT_MazeGen_GenerateMaze, summary.generateMs);
+	const MazeCore::FMazeEndpoints endpoints = MazeCore::ChooseEndpoints(mazeGrid, random);
+	MazeCore::GenerateMaze(mazeGrid, random, mazeAlgorithm, endpoints.startX, endpoints.startY, cancel);
+	MazeCore::OpenEndpoints(mazeGrid, endpoints);
+	return endpoints;
+}
+
+void AABacktrace_MazeGen::BuildInstanceBuffers(const MazeCore::FMazeGrid& mazeGrid, const MazeCore::FMazeLayoutSettings& settings, FMazeInstanceBuffers& outBuffers,
+	FMazeGenerationSummary& summary)
+{
+	MAZEGEN_STAGE_SCOPE(STAT_MazeGen_BuildTransforms, summary.buildTransformsMs);
+	MazeCore::FMazeLayout layout;
+	MazeCore::BuildMazeLayout(mazeGrid, settings, layout);
+	outBuffers.BuildFromLayout(layout);
+}
+
+FMazeGenCacheEntryPtr AABacktrace_MazeGen::FindOrGenerateMaze(const FMazeGenCacheKey& key, const MazeCore::FMazeLayoutSettings& settings,
+	FMazeGenerationSummary& summary, const MazeCore::FMazeCancelFlag* cancel)
+{
+	if (FMazeGenCacheEntryPtr cached = FMazeGenCache::Get().Find(key))
+	{
+		summary.bFromCache = true;
+		return cached;
+	}
+
+	TSharedPtr<FMazeGenCacheEntry, ESPMode::ThreadSafe> entry = MakeShared<FMazeGenCacheEntry, ESPMode::ThreadSafe>();
+	entry->endpoints = GenerateGrid(entry->grid, key.width, key.height, MazeCore::EMazeGenAlgorithm(key.algorithm), key.seed, summary, cancel);
+	if (cancel && cancel->load()) {
+		return nullptr;
+	}
+	BuildInstanceBuffers(entry->grid, settings, entry->instances, summary);
+	if (cancel && cancel->load()) {
+		return nullptr;
+	}
+
+	FMazeGenCache::Get().Add(key, entry);
+	return entry;
+}
 
 /*===================
 VisualiseMaze
 
 Visualizes the generated maze by instantiating floor and wall meshes at the correct positions.
-Walls are placed based on the state of each grid cell, with north, south, east, and west walls added accordingly.
+Each closed wall is placed once, and with bMergeWalls straight runs of walls become a single stretched instance.
 Materials are applied to the mesh components for proper rendering.
 Instances are added in bulk for performance optimization.
 ===================*/
 void AABacktrace_MazeGen::VisualiseMaze()
 {
-	// Assume these are set up in the actor's constructor
-	UInstancedStaticMeshComponent* floorComponent = m_floorStaticMeshComponent;
-	UInstancedStaticMeshComponent* hWallComponent = m_defaultWallStaticMeshComponent;
-	UInstancedStaticMeshComponent* vWallComponent = m_rotatedWallStaticMeshComponent;
+	// Create arrays to hold the instances for floor and walls
+	FMazeInstanceBuffers instances;
+	BuildInstanceBuffers(grid, GetLayoutSettings(), instances, m_summary);
 
+	VisualiseMaze(instances);
+}
+
+void AABacktrace_MazeGen::VisualiseMaze(const FMazeInstanceBuffers& instances)
+{
 	// Assign Material
 	m_floorStaticMeshComponent->SetMaterial(0, m_floorInstancedMaterial);
 	m_defaultWallStaticMeshComponent->SetMaterial(0, m_defaultWallInstancedMaterial);
 	m_rotatedWallStaticMeshComponent->SetMaterial(0, m_rotatedWallInstancedMaterial);
 
-	// Create arrays to hold the instances for floor and walls
-	TArray<FTransform> floorInstances;
-	TArray<FTransform> hWallInstances;
-	TArray<FTransform> vWallInstances;
+	// Now replace the previous maze, adding all the instances at once
+	{
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_AddInstances, m_summary.addInstancesMs);
+		FMazeInstanceBuffers::ClearFrom(m_floorStaticMeshComponent, m_defaultWallStaticMeshComponent, m_rotatedWallStaticMeshComponent);
+		instances.AddTo(m_floorStaticMeshComponent, m_defaultWallStaticMeshComponent, m_rotatedWallStaticMeshComponent);
+	}
+	InitWallEdits();
+	FinishSummary(instances);
+}
 
-	/*NEW*/
-	for (int x = 0; x < levelWidth; x++) {
-		for (int y = 0; y < levelHeight; y++) {
-			FVector location = FVector(x * positionScaling, y * positionScaling, 0);
-
-			// Floor (unchanged)
-			FVector floorScale = FVector(1.0f * meshScaling.X, 1.0f * meshScaling.Y, 0.1f * meshScaling.Z);
-			FTransform floorTransform(FRotator::ZeroRotator, location, floorScale);
-			floorInstances.Add(floorTransform);
-
-			// Walls adjusted to cell edges
-			if (grid[x][y].northWall) {
-				FVector wallLocation = FVector(x * positionScaling + zOffset, (y + 1) * positionScaling, 0);
-				FVector wallScale = FVector(1.0f * meshScaling.X, 0.1f * meshScaling.Y, 1.0f * meshScaling.Z);
-				FTransform wallTransform(FRotator::ZeroRotator, wallLocation, wallScale);
-				hWallInstances.Add(wallTransform);
-			}
-			if (grid[x][y].southWall) {
-				FVector wallLocation = FVector(x * positionScaling + zOffset, y * positionScaling, 0);
-				FVector wallScale = FVector(1.0f * meshScaling.X, 0.1f * meshScaling.Y, 1.0f * meshScaling.Z);
-				FTransform wallTransform(FRotator::ZeroRotator, wallLocation, wallScale);
-				hWallInstances.Add(wallTransform);
-			}
-			if (grid[x][y].eastWall) {
-				FVector wallLocation = FVector((x + 1) * positionScaling, y * positionScaling + zOffset, 0);
-				FVector wallScale = FVector(0.1f * meshScaling.X, 1.0f * meshScaling.Y, 1.0f * meshScaling.Z);
-				FTransform wallTransform(FRotator::ZeroRotator, wallLocation, wallScale);
-				vWallInstances.Add(wallTransform);
-			}
-			if (grid[x][y].westWall) {
-				FVector wallLocation = FVector(x * positionScaling, y * positionScaling + zOffset, 0);
-				FVector wallScale = FVector(0.1f * meshScaling.X, 1.0f * meshScaling.Y, 1.0f * meshScaling.Z);
-				FTransform wallTransform(FRotator::ZeroRotator, wallLocation, wallScale);
-				vWallInstances.Add(wallTransform);
-			}
-		}
+void AABacktrace_MazeGen::BeginSummary(bool bAsync)
+{
+	if (m_summary.cellCount > 0) {
+		FMazeGenStats::RemoveMaze(m_summary);
 	}
+	m_summary = FMazeGenerationSummary();
+	m_summary.width = levelWidth;
+	m_summary.height = levelHeight;
+	m_summary.seed = seed;
+	m_summary.bAsync = bAsync;
+	m_summaryStartTime = FPlatformTime::Seconds();
+}
 
-	// Now add all the instances at once
-	floorComponent->AddInstances(floorInstances, true);
-	hWallComponent->AddInstances(hWallInstances, true);
-	vWallComponent->AddInstances(vWallInstances, true);
+void AABacktrace_MazeGen::FinishSummary(const FMazeInstanceBuffers& instances)
+{
+	m_summary.cellCount = grid.GetCellCount();
+	m_summary.wallCount = int32(grid.CountWalls());
+	m_summary.wallInstanceCount = instances.defaultWalls.Num() + instances.rotatedWalls.Num();
+	m_summary.floorInstanceCount = instances.floors.Num();
+	m_summary.gridBytes = int64(grid.GetAllocatedSize());
+	m_summary.transformBytes = int64(instances.GetAllocatedSize());
+	m_summary.solverBytes = int64(m_solver.GetAllocatedSize() + m_exitSolver.GetAllocatedSize() + m_flowField.GetAllocatedSize()
+		+ m_treeIndex.GetAllocatedSize() + m_corridorGraph.GetAllocatedSize() + m_horizontalWalls.GetAllocatedSize() + m_verticalWalls.GetAllocatedSize());
+	m_summary.totalMs = float((FPlatformTime::Seconds() - m_summaryStartTime) * 1000.0);
+	FMazeGenStats::AddMaze(m_summary);
+	UE_LOG(LogTemp, Log, TEXT("Backtrace maze generated: %s"), *m_summary.ToString());
 }
 
-/*NEW*/
 /*===================
-GenerateMaze
+InitWallEdits
 
-Generates a maze using a recursive backtracking algorithm. It marks cells as visited,
-identifies valid neighbors, shuffles them for randomness, and removes walls between
-neighboring cells. The function recursively explores and backtracks until the maze is complete.
+The maps number the wall instances from zero in layout order, so they only describe components
+that hold this maze's walls and nothing else.
 ===================*/
-void AABacktrace_MazeGen::GenerateMaze(int x, int y)
+void AABacktrace_MazeGen::InitWallEdits()
 {
-	// Step 1: Mark the current cell as visited
-	// Step 2: Identify valid neighbors (left, right, up, down)
-	// Step 3: Shuffle the neighbors to ensure random path generation
-	// Step 4: Visit each neighbor
-	// Step 5: Recursively visit the neighbor
-	// Step 6: Backtrack when no unvisited neighbors remain
+	m_horizontalWalls = MazeCore::FMazeWallInstances();
+	m_verticalWalls = MazeCore::FMazeWallInstances();
+	m_regionShuffle.Cancel();
+	m_shiftRandom.Seed(MazeCore::MixSeed(uint64(seed), BacktraceShiftSalt));
+	m_shiftTimer = 0.0f;
+	m_bSolversOutdated = false;
+	m_bWallsEdited = false;
+	SetActorTickEnabled(false);
+	if (!bEnableWallEdits) {
+		return;
+	}
 
+	m_horizontalWalls.Build(grid, true, bMergeWalls);
+	m_verticalWalls.Build(grid, false, bMergeWalls);
+	if (m_defaultWallStaticMeshComponent->GetInstanceCount() != m_horizontalWalls.GetInstanceCount()
+		|| m_rotatedWallStaticMeshComponent->GetInstanceCount() != m_verticalWalls.GetInstanceCount())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Wall components hold other instances as well as the maze, wall edits disabled"));
+		m_horizontalWalls = MazeCore::FMazeWallInstances();
+		m_verticalWalls = MazeCore::FMazeWallInstances();
+	}
+	else {
+		// Sized here, with the maze, rather than in the frame that starts a shift
+		m_regionShuffle.Reserve(grid);
+	}
+	UpdateTickEnabled();
+}
 
-	// Step 1: Mark the current cell as visited
-	grid[x][y].visited = true;
+void AABacktrace_MazeGen::InitSolvers()
+{
+	BuildSolvers(grid, m_endpoints, bBuildDistanceIndex, bUseCorridorGraph, m_solver, m_exitSolver, m_flowField, m_treeIndex, m_corridorGraph, m_summary);
+}
 
-	// Step 2: Identify valid neighbors (left, right, up, down)
-	TArray<FIntPoint> neighbors;
-	if (x > 0 && !grid[x - 1][y].visited)
-	{
-		neighbors.Add(FIntPoint(x - 1, y)); // Left
+void AABacktrace_MazeGen::RebindSolvers()
+{
+	m_solver.Rebind(grid);
+	m_exitSolver.Rebind(grid);
+	m_flowField.Rebind(grid);
+	m_corridorGraph.Rebind(grid);
+}
+
+/*===================
+BuildSolvers
+
+Only reads the grid, so async generation runs it on the worker: the exit's distance field and
+flow field each search the whole maze (about 50 ms apiece at 1024 x 1024).
+===================*/
+void AABacktrace_MazeGen::BuildSolvers(const MazeCore::FMazeGrid& mazeGrid, const MazeCore::FMazeEndpoints& endpoints, bool bBuildIndex, bool bBuildGraph,
+	MazeCore::FMazeSolver& outSolver, MazeCore::FMazeSolver& outExitSolver, MazeCore::FMazeFlowField& outFlowField, MazeCore::FMazeTreeIndex& outTreeIndex,
+	MazeCore::FMazeCorridorGraph& outCorridorGraph, FMazeGenerationSummary& summary)
+{
+	MAZEGEN_STAGE_SCOPE(STAT_MazeGen_InitSolvers, summary.solversMs);
+	outSolver.Init(mazeGrid);
+	outExitSolver.Init(mazeGrid);
+	outExitSolver.ComputeDistanceField(endpoints.exitX, endpoints.exitY);
+	outFlowField.Init(mazeGrid);
+	outFlowField.AddGoal(endpoints.exitX, endpoints.exitY);
+
+	outTreeIndex = MazeCore::FMazeTreeIndex();
+	if (bBuildIndex && !outTreeIndex.Build(mazeGrid)) {
+		UE_LOG(LogTemp, Warning, TEXT("Maze has loops, distance index not built"));
+	}
+
+	outCorridorGraph = MazeCore::FMazeCorridorGraph();
+	if (bBuildGraph) {
+		outCorridorGraph.Build(mazeGrid);
+	}
+}
+
+bool AABacktrace_MazeGen::IsValidCell(const FIntPoint& cell) const
+{
+	return cell.X >= 0 && cell.Y >= 0 && cell.X < grid.GetWidth() && cell.Y < grid.GetHeight();
+}
+
+bool AABacktrace_MazeGen::CanUseCorridorGraph() const
+{
+	// The graph keeps the corridors of the walls it was built on, and walking them reads the live grid
+	return m_corridorGraph.GetNodeCount() > 0 && !m_bSolversOutdated;
+}
+
+int32 AABacktrace_MazeGen::SearchPath(const FIntPoint& start, const FIntPoint& goal)
+{
+	if (CanUseCorridorGraph()) {
+		return m_corridorGraph.FindPath(start.X, start.Y, goal.X, goal.Y, m_pathCells);
 	}
+	return m_solver.FindPath(start.X, start.Y, goal.X, goal.Y, m_pathCells);
+}
 
-	if (x < levelWidth - 1 && !grid[x + 1][y].visited) {
-		neighbors.Add(FIntPoint(x + 1, y)); // Right
+/*===================
+ToCellPoints
+
+Converts packed cell indices into grid coordinates for Blueprint.
+===================*/
+static void ToCellPoints(const std::vector<int32_t>& cells, int32 width, TArray<FIntPoint>& outPoints)
+{
+	outPoints.Reset(int32(cells.size()));
+	for (const int32_t cell : cells) {
+		outPoints.Emplace(cell % width, cell / width);
 	}
+}
+
+FIntPoint AABacktrace_MazeGen::WorldToCell(const FVector& worldLocation) const
+{
+	const FVector local = GetActorTransform().InverseTransformPosition(worldLocation);
+	return FIntPoint(
+		FMath::Clamp(FMath::FloorToInt32(local.X / positionScaling), 0, FMath::Max(0, grid.GetWidth() - 1)),
+		FMath::Clamp(FMath::FloorToInt32(local.Y / positionScaling), 0, FMath::Max(0, grid.GetHeight() - 1)));
+}
 
-	if (y > 0 && !grid[x][y - 1].visited) {
-		neighbors.Add(FIntPoint(x, y - 1)); // Down
+FVector AABacktrace_MazeGen::CellToWorld(const FIntPoint& cell) const
+{
+	return GetActorTransform().TransformPosition(FVector((cell.X + 0.5f) * positionScaling, (cell.Y + 0.5f) * positionScaling, 0.0f));
+}
+
+bool AABacktrace_MazeGen::FindPath(const FIntPoint& start, const FIntPoint& goal, TArray<FIntPoint>& outPath)
+{
+	outPath.Reset();
+	if (!IsValidCell(start) || !IsValidCell(goal)) {
+		return false;
+	}
+	if (SearchPath(start, goal) < 0) {
+		return false;
 	}
+	ToCellPoints(m_pathCells, grid.GetWidth(), outPath);
+	return true;
+}
 
-	if (y < levelHeight - 1 && !grid[x][y + 1].visited) {
-		neighbors.Add(FIntPoint(x, y + 1)); // Up
+bool AABacktrace_MazeGen::FindPathToExit(const FIntPoint& from, TArray<FIntPoint>& outPath) const
+{
+	outPath.Reset();
+	if (!IsValidCell(from) || m_exitSolver.GetPathToFieldStart(from.X, from.Y, m_pathCells) < 0) {
+		return false;
 	}
+	ToCellPoints(m_pathCells, grid.GetWidth(), outPath);
+	return true;
+}
 
-	// Step 3: Shuffle the neighbors to ensure random path generation
-	for (int i = neighbors.Num() - 1; i > 0; i--) {
-		int j = FMath::RandRange(0, i);
-		neighbors.Swap(i, j);
+int32 AABacktrace_MazeGen::GetDistanceToExit(const FIntPoint& cell) const
+{
+	return IsValidCell(cell) ? m_exitSolver.GetDistance(cell.X, cell.Y) : -1;
+}
+
+bool AABacktrace_MazeGen::ComputeDistanceField(const FIntPoint& from)
+{
+	if (!IsValidCell(from)) {
+		return false;
+	}
+	m_bFieldOnGraph = CanUseCorridorGraph();
+	if (m_bFieldOnGraph) {
+		m_corridorGraph.ComputeDistanceField(from.X, from.Y);
+	}
+	else {
+		m_solver.ComputeDistanceField(from.X, from.Y);
 	}
+	return true;
+}
 
-	// Step 4: Visit each neighbor
-	for (int i = 0; i < neighbors.Num(); i++) {
-		int nx = neighbors[i].X;
-		int ny = neighbors[i].Y;
+int32 AABacktrace_MazeGen::GetFieldDistance(const FIntPoint& cell) const
+{
+	if (!IsValidCell(cell)) {
+		return -1;
+	}
+	return m_bFieldOnGraph ? m_corridorGraph.GetDistance(cell.X, cell.Y) : m_solver.GetDistance(cell.X, cell.Y);
+}
 
-		if (!grid[nx][ny].visited) {
-			// Remove the wall between the current cell and the neighbor
-			if (nx < x) { // Neighbor is to the left
-				grid[x][y].westWall = false;
-				grid[nx][ny].eastWall = false;
-			}
-			else if (nx > x) { // Neighbor is to the right
-				grid[x][y].eastWall = false;
-				grid[nx][ny].westWall = false;
-			}
-			else if (ny < y) { // Neighbor is below
-				grid[x][y].southWall = false;
-				grid[nx][ny].northWall = false;
-			}
-			else if (ny > y) { // Neighbor is above
-				grid[x][y].northWall = false;
-				grid[nx][ny].southWall = false;
-			}
+bool AABacktrace_MazeGen::ExportMaze(const FString& filePath) const
+{
+	if (grid.GetCellCount() == 0 || IsGenerating()) {
+		return false;
+	}
+	const MazeCore::FMazeFileHeader header = MazeCore::MakeMazeFileHeader(grid, uint64(seed), static_cast<MazeCore::EMazeGenAlgorithm>(algorithm), m_endpoints);
+	return FMazeFileIO::Save(filePath, grid, header);
+}
+
+/*===================
+ImportMaze
+
+The file is read straight into the grid, reusing its memory when the size is unchanged. The
+header is checked before the grid is touched, so an invalid file leaves the maze as it was.
+The settings describing the maze (size, seed, algorithm) are taken from the file.
+===================*/
+bool AABacktrace_MazeGen::ImportMaze(const FString& filePath)
+{
+	CancelGeneration();
 
-			// Step 5: Recursively visit the neighbor
-			GenerateMaze(nx, ny);
+	// The file is loaded beside the current maze, which is only replaced once nothing can fail
+	const double startTime = FPlatformTime::Seconds();
+	MazeCore::FMazeGrid loadedGrid;
+	MazeCore::FMazeFileHeader header;
+	float loadMs = 0.0f;
+	{
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_GenerateMaze, loadMs);
+		if (!FMazeFileIO::Load(filePath, loadedGrid, header)) {
+			UE_LOG(LogTemp, Warning, TEXT("%s is not a valid maze file"), *filePath);
+			return false;
 		}
 	}
+	UE_LOG(LogTemp, Log, TEXT("Loaded maze %d x %d from %s in %.2f ms"), header.width, header.height, *filePath, loadMs);
+
+	if (!SetupMeshComponents()) {
+		return false;
+	}
+
+	grid = MoveTemp(loadedGrid);
+	m_endpoints = MazeCore::GetMazeFileEndpoints(header);
+	levelWidth = header.width;
+	levelHeight = header.height;
+	seed = int64(header.seed);
+	if (header.algorithm <= uint32(EMazeAlgorithm::Prim)) {
+		algorithm = static_cast<EMazeAlgorithm>(header.algorithm);
+	}
+
+	// Loading stands in for generation in the summary
+	BeginSummary(false);
+	m_summary.generateMs = loadMs;
+	m_summaryStartTime = startTime;
+
+	InitSolvers();
+	VisualiseMaze();
+	OnMazeGenerated.Broadcast();
+	return true;
+}
+
+int32 AABacktrace_MazeGen::GetCellDistance(const FIntPoint& a, const FIntPoint& b)
+{
+	if (!IsValidCell(a) || !IsValidCell(b)) {
+		return -1;
+	}
+	if (m_treeIndex.IsBuilt()) {
+		return m_treeIndex.GetDistance(a.X, a.Y, b.X, b.Y);
+	}
+	return SearchPath(a, b);
+}
+
+bool AABacktrace_MazeGen::IsCellOnPath(const FIntPoint& cell, const FIntPoint& a, const FIntPoint& b)
+{
+	if (!IsValidCell(cell) || !IsValidCell(a) || !IsValidCell(b)) {
+		return false;
+	}
+	if (m_treeIndex.IsBuilt()) {
+		return m_treeIndex.IsOnPath(cell.X, cell.Y, a.X, a.Y, b.X, b.Y);
+	}
+	SearchPath(a, b);
+	return std::find(m_pathCells.begin(), m_pathCells.end(), grid.GetCellIndex(cell.X, cell.Y)) != m_pathCells.end();
+}
+
+bool AABacktrace_MazeGen::AddFlowGoal(const FIntPoint& cell)
+{
+	if (!IsValidCell(cell)) {
+		return false;
+	}
+	m_flowField.AddGoal(cell.X, cell.Y);
+	return true;
+}
+
+bool AABacktrace_MazeGen::RemoveFlowGoal(const FIntPoint& cell)
+{
+	if (!IsValidCell(cell)) {
+		return false;
+	}
+	m_flowField.RemoveGoal(cell.X, cell.Y);
+	return true;
+}
+
+void AABacktrace_MazeGen::ResetFlowGoals()
+{
+	if (IsValidCell(GetExitCell())) {
+		m_flowField.ClearGoals();
+		m_flowField.AddGoal(m_endpoints.exitX, m_endpoints.exitY);
+	}
+}
+
+FIntPoint AABacktrace_MazeGen::GetFlowStep(const FIntPoint& cell) const
+{
+	if (!IsValidCell(cell)) {
+		return FIntPoint::ZeroValue;
+	}
+	switch (m_flowField.GetDirection(cell.X, cell.Y))
+	{
+	case MazeCore::EMazeFlowDirection::West: return FIntPoint(-1, 0);
+	case MazeCore::EMazeFlowDirection::East: return FIntPoint(1, 0);
+	case MazeCore::EMazeFlowDirection::South: return FIntPoint(0, -1);
+	case MazeCore::EMazeFlowDirection::North: return FIntPoint(0, 1);
+	default: return FIntPoint::ZeroValue;
+	}
+}
+
+int32 AABacktrace_MazeGen::GetFlowDistance(const FIntPoint& cell) const
+{
+	return IsValidCell(cell) ? m_flowField.GetDistance(cell.X, cell.Y) : -1;
+}
 
-	// Step 6: Backtrack when no unvisited neighbors remain
-	// (Handled implicitly by the recursion: the function returns when there are no unvisited neighbors)
+FVector AABacktrace_MazeGen::GetFlowDirectionAtLocation(const FVector& worldLocation) const
+{
+	const FIntPoint cell = WorldToCell(worldLocation);
+	if (GetFlowDistance(cell) < 0) {
+		return FVector::ZeroVector;
+	}
+	return (CellToWorld(cell + GetFlowStep(cell)) - worldLocation).GetSafeNormal2D();
 }
 
 // Called when the game starts or when spawned
@@ -295,10 +745,322 @@ void AABacktrace_MazeGen::BeginPlay()
 	GenerateMazeMeshes();
 }
 
+void AABacktrace_MazeGen::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelGeneration();
+	if (m_summary.cellCount > 0)
+	{
+		FMazeGenStats::RemoveMaze(m_summary);
+		m_summary = FMazeGenerationSummary();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+/*===================
+GetWallEdge
+
+Grid line and position along it of one side of a cell. North and south walls lie on horizontal
+lines, east and west walls on vertical lines.
+===================*/
+static void GetWallEdge(const FIntPoint& cell, EMazeWallSide side, bool& bOutHorizontal, int32& outLine, int32& outPosition)
+{
+	bOutHorizontal = side == EMazeWallSide::North || side == EMazeWallSide::South;
+	outPosition = bOutHorizontal ? cell.X : cell.Y;
+	switch (side)
+	{
+	case EMazeWallSide::North:	outLine = cell.Y + 1; break;
+	case EMazeWallSide::South:	outLine = cell.Y; break;
+	case EMazeWallSide::East:	outLine = cell.X + 1; break;
+	default:					outLine = cell.X; break;
+	}
+}
+
+bool AABacktrace_MazeGen::HasWall(const FIntPoint& cell, EMazeWallSide side) const
+{
+	if (!IsValidCell(cell)) {
+		return false;
+	}
+	bool bHorizontal;
+	int32 line, position;
+	GetWallEdge(cell, side, bHorizontal, line, position);
+	return bHorizontal ? grid.HasHorizontalWall(position, line) : grid.HasVerticalWall(line, position);
+}
+
+/*===================
+SetWall
+
+Changes the grid and the wall runs straight away, so queries see the edit at once. The instance
+changes wait for FlushWallEdits, which the actor's tick calls at the end of the frame.
+===================*/
+bool AABacktrace_MazeGen::SetWall(const FIntPoint& cell, EMazeWallSide side, bool bClosed)
+{
+	if (!IsValidCell(cell) || !m_horizontalWalls.IsBuilt() || IsGenerating()) {
+		return false;
+	}
+	bool bHorizontal;
+	int32 line, position;
+	GetWallEdge(cell, side, bHorizontal, line, position);
+	MazeCore::FMazeWallInstances& walls = bHorizontal ? m_horizontalWalls : m_verticalWalls;
+	if (!walls.SetWall(line, position, bClosed)) {
+		return false;
+	}
+
+	if (bHorizontal) {
+		grid.SetSouthWall(position, line, bClosed);
+	}
+	else {
+		grid.SetWestWall(line, position, bClosed);
+	}
+	m_bSolversOutdated = true;
+	m_bWallsEdited = true;
+
+	// A running shift has to know which parts of the maze around its region the edit joins
+	m_regionShuffle.NoteWallEdit({ bHorizontal, line, position }, bClosed);
+	SetActorTickEnabled(true);
+	return true;
+}
+
+/*===================
+RemoveWallAtLocation
+
+A wall faces across the grid line it stands on, so the normal picks the orientation, the nearest
+line of that orientation is the wall's line, and the cell edge along it contains the point.
+Points on upward facing surfaces are ignored.
+===================*/
+bool AABacktrace_MazeGen::RemoveWallAtLocation(const FVector& worldLocation, const FVector& worldNormal)
+{
+	const FVector local = GetActorTransform().InverseTransformPosition(worldLocation) / positionScaling;
+	const FVector localNormal = GetActorTransform().InverseTransformVectorNoScale(worldNormal);
+
+	// The floor and the tops of walls face up
+	if (FMath::Abs(localNormal.Z) > 0.7f) {
+		return false;
+	}
+	const bool bHorizontal = FMath::Abs(localNormal.Y) >= FMath::Abs(localNormal.X);
+	const int32 line = FMath::RoundToInt32(bHorizontal ? local.Y : local.X);
+	const int32 position = FMath::FloorToInt32(bHorizontal ? local.X : local.Y);
+
+	// The top and right border lines belong to the last row and column
+	const int32 lineCount = bHorizontal ? grid.GetHeight() : grid.GetWidth();
+	const bool bFarBorder = line == lineCount;
+	const int32 cellLine = bFarBorder ? line - 1 : line;
+	const FIntPoint cell = bHorizontal ? FIntPoint(position, cellLine) : FIntPoint(cellLine, position);
+	const EMazeWallSide side = bHorizontal ? (bFarBorder ? EMazeWallSide::North : EMazeWallSide::South)
+		: (bFarBorder ? EMazeWallSide::East : EMazeWallSide::West);
+	return SetWall(cell, side, false);
+}
+
+/*===================
+FlushWallInstances
+
+Brings one wall component in line with its wall runs. Changed instances that remain are rewritten
+in batches of consecutive indices, instances past the new count are removed from the end (their
+runs were already moved down into freed slots), and new runs are appended. The render state is
+marked dirty once for the whole flush.
+===================*/
+static void FlushWallInstances(MazeCore::FMazeWallInstances& walls, UInstancedStaticMeshComponent* component, const MazeCore::FMazeLayoutSettings& settings)
+{
+	if (!walls.HasChanges()) {
+		return;
+	}
+
+	auto makeTransform = [&walls, &settings](int32 instance)
+	{
+		const MazeCore::FMazeWallRun& run = walls.GetInstanceRun(instance);
+		return FMazeInstanceBuffers::ToTransform(MazeCore::MakeWallInstance(walls.IsHorizontal(), run.line, run.start, run.length, settings));
+	};
+
+	const int32 count = walls.GetInstanceCount();
+	const int32 committedCount = walls.GetCommittedCount();
+	const int32 keptCount = FMath::Min(count, committedCount);
+
+	TArray<int32> dirty(walls.GetDirtyInstances().data(), int32(walls.GetDirtyInstances().size()));
+	dirty.Sort();
+	TArray<FTransform> transforms;
+	int32 updatedCount = FMath::Abs(count - committedCount);
+	for (int32 i = 0; i < dirty.Num() && dirty[i] < keptCount; )
+	{
+		const int32 first = dirty[i];
+		transforms.Reset();
+		while (i < dirty.Num() && dirty[i] == first + transforms.Num() && dirty[i] < keptCount)
+		{
+			transforms.Add(makeTransform(dirty[i]));
+			i++;
+		}
+		component->BatchUpdateInstancesTransforms(first, transforms, false, false, true);
+		updatedCount += transforms.Num();
+	}
+	INC_DWORD_STAT_BY(STAT_MazeGen_WallInstanceUpdates, updatedCount);
+
+	if (committedCount > count)
+	{
+		TArray<int32> removed;
+		removed.Reserve(committedCount - count);
+		for (int32 instance = committedCount - 1; instance >= count; instance--) {
+			removed.Add(instance);
+		}
+		component->RemoveInstances(removed);
+	}
+
+	if (count > committedCount)
+	{
+		transforms.Reset();
+		for (int32 instance = committedCount; instance < count; instance++) {
+			transforms.Add(makeTransform(instance));
+		}
+		component->AddInstances(transforms, false);
+	}
+
+	component->MarkRenderStateDirty();
+	walls.Commit();
+}
+
+void AABacktrace_MazeGen::FlushWallEdits()
+{
+	MAZEGEN_SCOPE(STAT_MazeGen_FlushWallEdits);
+	if (m_horizontalWalls.HasChanges() || m_verticalWalls.HasChanges())
+	{
+		const MazeCore::FMazeLayoutSettings settings = GetLayoutSettings();
+		FlushWallInstances(m_horizontalWalls, m_defaultWallStaticMeshComponent, settings);
+		FlushWallInstances(m_verticalWalls, m_rotatedWallStaticMeshComponent, settings);
+	}
+
+	// Shifts leave the refresh to the caller, since on a large maze it costs far more than the budget
+	if (bRefreshSolversOnWallEdit && m_bWallsEdited) {
+		RefreshSolvers();
+	}
+	UpdateTickEnabled();
+}
+
+void AABacktrace_MazeGen::RefreshSolvers()
+{
+	MAZEGEN_SCOPE(STAT_MazeGen_RefreshSolvers);
+	m_bSolversOutdated = false;
+	m_bWallsEdited = false;
+	if (grid.GetCellCount() == 0) {
+		return;
+	}
+	m_exitSolver.ComputeDistanceField(m_endpoints.exitX, m_endpoints.exitY);
+	m_flowField.Rebuild();
+
+	// An opened wall can close a loop, after which distance queries fall back to searching
+	const bool bWasIndexed = m_treeIndex.IsBuilt();
+	if (bBuildDistanceIndex && !m_treeIndex.Build(grid) && bWasIndexed) {
+		UE_LOG(LogTemp, Warning, TEXT("Maze has loops after wall edits, distance index dropped"));
+	}
+	if (bUseCorridorGraph) {
+		m_corridorGraph.Build(grid);
+	}
+}
+
+bool AABacktrace_MazeGen::ShiftRegion(const FIntPoint& minCell, const FIntPoint& size)
+{
+	if (!m_horizontalWalls.IsBuilt() || IsGenerating() || IsShifting()) {
+		return false;
+	}
+	if (!m_regionShuffle.Start(grid, minCell.X, minCell.Y, size.X, size.Y, m_shiftRandom.Next())) {
+		return false;
+	}
+	m_nextShiftedWall = 0;
+	SetActorTickEnabled(true);
+	return true;
+}
+
+bool AABacktrace_MazeGen::ShiftRandomRegion()
+{
+	if (grid.GetCellCount() == 0) {
+		return false;
+	}
+	const int32 x = m_shiftRandom.RandRange(0, FMath::Max(0, grid.GetWidth() - shiftRegionSize.X));
+	const int32 y = m_shiftRandom.RandRange(0, FMath::Max(0, grid.GetHeight() - shiftRegionSize.Y));
+	return ShiftRegion(FIntPoint(x, y), shiftRegionSize);
+}
+
+void AABacktrace_MazeGen::CancelShift()
+{
+	if (m_regionShuffle.IsRunning() && !m_regionShuffle.HasChangedGrid())
+	{
+		m_regionShuffle.Cancel();
+		UpdateTickEnabled();
+	}
+}
+
+/*===================
+AdvanceShift
+
+Runs the shift in steps of a few thousand cells until the frame's budget is spent, writing the new
+region a few rows per step. Once it is all in the grid, its changed walls go to the wall runs, also
+within the budget, and the end of frame flush sends only the changed instances to the components.
+===================*/
+void AABacktrace_MazeGen::AdvanceShift()
+{
+	// About 0.1 ms of work, so the budget is overrun by at most that much
+	static const int32 ShiftStepCells = 4096;
+	static const int32 ShiftWallsPerCheck = 256;
+
+	if (!IsShifting()) {
+		return;
+	}
+	MAZEGEN_SCOPE(STAT_MazeGen_ShiftRegion);
+	const double deadline = FPlatformTime::Seconds() + shiftBudgetMs / 1000.0;
+	while (!m_regionShuffle.IsDone())
+	{
+		m_regionShuffle.Advance(grid, ShiftStepCells);
+		if (m_regionShuffle.HasChangedGrid()) {
+			m_bSolversOutdated = true;
+		}
+		if (FPlatformTime::Seconds() >= deadline) {
+			return;
+		}
+	}
+
+	// Set each wall run to the grid, which later wall edits may already have changed again
+	const std::vector<MazeCore::FMazeWallEdge>& changedWalls = m_regionShuffle.GetChangedWalls();
+	while (m_nextShiftedWall < int32(changedWalls.size()))
+	{
+		const int32 last = FMath::Min(m_nextShiftedWall + ShiftWallsPerCheck, int32(changedWalls.size()));
+		for (; m_nextShiftedWall < last; m_nextShiftedWall++)
+		{
+			const MazeCore::FMazeWallEdge& edge = changedWalls[m_nextShiftedWall];
+			if (edge.bHorizontal) {
+				m_horizontalWalls.SetWall(edge.line, edge.position, grid.HasHorizontalWall(edge.position, edge.line));
+			}
+			else {
+				m_verticalWalls.SetWall(edge.line, edge.position, grid.HasVerticalWall(edge.line, edge.position));
+			}
+		}
+		if (FPlatformTime::Seconds() >= deadline) {
+			return;
+		}
+	}
+
+	const FIntPoint minCell(m_regionShuffle.GetMinX(), m_regionShuffle.GetMinY());
+	const FIntPoint size(m_regionShuffle.GetWidth(), m_regionShuffle.GetHeight());
+	m_regionShuffle.Cancel();
+	m_shiftTimer = 0.0f;
+	OnRegionShifted.Broadcast(minCell, size);
+}
+
+void AABacktrace_MazeGen::UpdateTickEnabled()
+{
+	const bool bWallsChanged = m_horizontalWalls.HasChanges() || m_verticalWalls.HasChanges();
+	SetActorTickEnabled(bWallsChanged || IsShifting() || (bAutoShift && m_horizontalWalls.IsBuilt()));
+}
+
 // Called every frame
 void AABacktrace_MazeGen::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-}
+	if (bAutoShift && m_horizontalWalls.IsBuilt() && !IsShifting())
+	{
+		m_shiftTimer += DeltaTime;
+		if (m_shiftTimer >= shiftInterval) {
+			ShiftRandomRegion();
+		}
+	}
+	AdvanceShift();
 
+	// Only enabled while there is something to do
+	FlushWallEdits();
+}
@@ -0,0 +1,165 @@
+// Author: Joshua Hall - Griffith University
+// Class: AAChunked_MazeGen
+// Purpose: This class streams an effectively infinite maze around the player in fixed-size chunks.
+// License: MIT
+
+
+#include "AChunked_MazeGen.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "MazeCore/MazeChunks.h"
+#include "MazeCore/MazeLayout.h"
+#include "MazeInstanceBuffers.h"
+#include "MazeMeshComponents.h"
+
+// Sets default values
+AAChunked_MazeGen::AAChunked_MazeGen()
+{
+	// Tick is used to follow the player and stream chunks in and out
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Create and set Root Component if not already set
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+}
+
+// Called when the game starts or when spawned
+void AAChunked_MazeGen::BeginPlay()
+{
+	Super::BeginPlay();
+	if (GEngine) {
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, "Stream Chunked Maze");
+	}
+
+	// Pick the seed. Every chunk is derived from it.
+	if (bRandomizeSeed) {
+		seed = (int64(FMath::Rand()) << 32) ^ int64(FPlatformTime::Cycles64());
+	}
+
+	// Create Materials, shared by every chunk
+	m_floorInstancedMaterial = UMaterialInstanceDynamic::Create(floorMaterial, this);
+	m_defaultWallInstancedMaterial = UMaterialInstanceDynamic::Create(defaultWallMaterial, this);
+	m_rotatedWallInstancedMaterial = UMaterialInstanceDynamic::Create(rotatedWallMaterial, this);
+}
+
+// Called every frame
+void AAChunked_MazeGen::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const APawn* pawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	UpdateStreaming(pawn ? pawn->GetActorLocation() : GetActorLocation());
+}
+
+/*===================
+UpdateStreaming
+
+Finds the chunk under the view location, unloads chunks more than loadRadius + 1 away
+(the extra ring stops chunks flickering in and out on a border) and loads missing chunks
+within loadRadius, nearest ring first, at most maxChunkLoadsPerFrame per call.
+===================*/
+void AAChunked_MazeGen::UpdateStreaming(const FVector& viewLocation)
+{
+	const FVector localLocation = GetActorTransform().InverseTransformPosition(viewLocation);
+	const float chunkWorldSize = float(chunkSize) * positionScaling;
+	const FIntPoint center(FMath::FloorToInt(localLocation.X / chunkWorldSize), FMath::FloorToInt(localLocation.Y / chunkWorldSize));
+
+	// Unload chunks that are out of range
+	TArray<FIntPoint> chunksToUnload;
+	for (const TPair<FIntPoint, FMazeChunkComponents>& loadedChunk : m_loadedChunks) {
+		const FIntPoint offset = loadedChunk.Key - center;
+		if (FMath::Max(FMath::Abs(offset.X), FMath::Abs(offset.Y)) > loadRadius + 1) {
+			chunksToUnload.Add(loadedChunk.Key);
+		}
+	}
+	for (const FIntPoint& chunk : chunksToUnload) {
+		UnloadChunk(chunk);
+	}
+
+	// Load missing chunks, nearest ring first
+	int loads = 0;
+	for (int ring = 0; ring <= loadRadius; ring++) {
+		for (int dy = -ring; dy <= ring; dy++) {
+			for (int dx = -ring; dx <= ring; dx++) {
+				if (FMath::Max(FMath::Abs(dx), FMath::Abs(dy)) != ring) {
+					continue;
+				}
+
+				const FIntPoint chunk = center + FIntPoint(dx, dy);
+				if (m_loadedChunks.Contains(chunk)) {
+					continue;
+				}
+
+				LoadChunk(chunk);
+				if (++loads >= maxChunkLoadsPerFrame) {
+					return;
+				}
+			}
+		}
+	}
+}
+
+/*===================
+LoadChunk
+
+Generates the chunk's maze, lays out its floors and walls in chunk-local space and adds them
+to new instanced mesh components placed at the chunk's origin. The grid itself is discarded;
+the chunk can always be generated again from the seed.
+===================*/
+void AAChunked_MazeGen::LoadChunk(const FIntPoint& chunk)
+{
+	MazeCore::FMazeGrid chunkGrid;
+	MazeCore::GenerateMazeChunk(chunkGrid, uint64(seed), chunk.X, chunk.Y, chunkSize);
+
+	MazeCore::FMazeLayoutSettings settings;
+	settings.positionScaling = positionScaling;
+	settings.meshScaleX = meshScaling.X;
+	settings.meshScaleY = meshScaling.Y;
+	settings.meshScaleZ = meshScaling.Z;
+	settings.zOffset = zOffset;
+	settings.bMergeWalls = bMergeWalls;
+	settings.floorLayout = static_cast<MazeCore::EMazeFloorLayout>(floorMode);
+
+	MazeCore::FMazeLayout layout;
+	MazeCore::BuildChunkLayout(chunkGrid, settings, layout);
+
+	FMazeInstanceBuffers instances;
+	instances.BuildFromLayout(layout);
+
+	const float chunkWorldSize = float(chunkSize) * positionScaling;
+	const FVector chunkOrigin(chunk.X * chunkWorldSize, chunk.Y * chunkWorldSize, 0.0f);
+
+	FMazeChunkComponents components;
+	components.floor = CreateChunkComponent(floorStaticMesh, m_floorInstancedMaterial, chunkOrigin);
+	components.defaultWalls = CreateChunkComponent(wallStaticMesh, m_defaultWallInstancedMaterial, chunkOrigin);
+	components.rotatedWalls = CreateChunkComponent(wallStaticMesh, m_rotatedWallInstancedMaterial, chunkOrigin);
+	instances.AddTo(components.floor, components.defaultWalls, components.rotatedWalls);
+
+	m_loadedChunks.Add(chunk, components);
+}
+
+void AAChunked_MazeGen::UnloadChunk(const FIntPoint& chunk)
+{
+	FMazeChunkComponents components;
+	if (!m_loadedChunks.RemoveAndCopyValue(chunk, components)) {
+		return;
+	}
+
+	for (UInstancedStaticMeshComponent* component : { components.floor, components.defaultWalls, components.rotatedWalls }) {
+		if (component) {
+			component->DestroyComponent();
+		}
+	}
+}
+
+UInstancedStaticMeshComponent* AAChunked_MazeGen::CreateChunkComponent(UStaticMesh* mesh, UMaterialInterface* material, const FVector& chunkOrigin)
+{
+	UInstancedStaticMeshComponent* component = FMazeMeshComponents::Create(this, bUseHierarchicalInstancing, chunkOrigin);
+	FMazeMeshComponents::SetCullDistance(component, instanceCullDistance);
+	if (mesh) {
+		component->SetStaticMesh(mesh);
+	}
+	if (material) {
+		component->SetMaterial(0, material);
+	}
+	return component;
+}
@@ -8,6 +8,11 @@
 
 #include "ATurn_MazeGen.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "MazeMeshComponents.h"
+#include "MazeGenCache.h"
+#include "MazeGenStats.h"
+#include "MazeInstanceBuffers.h"
+#include "Async/Async.h"
 
 // Sets default values
 AATurn_MazeGen::AATurn_MazeGen()
@@ -34,13 +39,77 @@ AATurn_MazeGen::AATurn_MazeGen()
 	m_rotatedWallStaticMeshComponent->SetMobility(EComponentMobility::Static);
 }
 
-void AATurn_MazeGen::GenerateMazeMeshes()
+/*===================
+FindOrBuildTurnMaze
+
+Thread-safe. Chooses which walls are rotated, places every floor and wall with the maze core
+layout and converts the placements into transforms. With bUseCache a maze built before with the same settings is taken from the
+generation cache instead, and a new one is added to it. The turn grid itself is not kept.
+Returns null if cancelled.
+===================*/
+static FMazeGenCacheEntryPtr FindOrBuildTurnMaze(int32 width, int32 height, uint64 seed, float cellSpacing, float rotationDeg, const FVector& scaling,
+	EMazeFloorMode floorMode, bool bUseCache, FMazeGenerationSummary& summary, const MazeCore::FMazeCancelFlag* cancel = nullptr)
 {
+	const FMazeGenCacheKey key = FMazeGenCacheKey::MakeTurn(seed, width, height, cellSpacing, rotationDeg, scaling, floorMode);
+	if (bUseCache)
+	{
+		if (FMazeGenCacheEntryPtr cached = FMazeGenCache::Get().Find(key))
+		{
+			summary.bFromCache = true;
+			return cached;
+		}
+	}
+
+	MazeCore::FMazeTurnGrid turnGrid;
+	{
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_AllocateGrid, summary.allocateMs);
+		turnGrid.Init(width, height);
+	}
+	{
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_GenerateMaze, summary.generateMs);
+		MazeCore::FMazeRandom random(seed);
+		MazeCore::GenerateTurnMaze(turnGrid, random);
+	}
+
+	TSharedPtr<FMazeGenCacheEntry, ESPMode::ThreadSafe> entry = MakeShared<FMazeGenCacheEntry, ESPMode::ThreadSafe>();
+	{
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_BuildTransforms, summary.buildTransformsMs);
+		MazeCore::FMazeLayoutSettings settings;
+		settings.positionScaling = cellSpacing;
+		settings.meshScaleX = scaling.X;
+		settings.meshScaleY = scaling.Y;
+		settings.meshScaleZ = scaling.Z;
+		settings.floorLayout = static_cast<MazeCore::EMazeFloorLayout>(floorMode);
+
+		MazeCore::FMazeLayout layout;
+		MazeCore::BuildTurnMazeLayout(turnGrid, settings, layout);
+		entry->instances.BuildFromLayout(layout, rotationDeg);
+	}
+	if (cancel && cancel->load()) {
+		return nullptr;
+	}
+
+	if (bUseCache) {
+		FMazeGenCache::Get().Add(key, entry);
+	}
+	return entry;
+}
+
+const FMazeGenerationSummary& AATurn_MazeGen::GenerateMazeMeshes()
+{
+	MAZEGEN_SCOPE(STAT_MazeGen_GenerateMeshes);
+
 	// Ensure components are valid before proceeding
 	if (!m_floorStaticMeshComponent || !m_defaultWallStaticMeshComponent || !m_rotatedWallStaticMeshComponent)
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, TEXT("Failed: One or more static mesh components are null!"));
-		return;
+		return m_summary;
+	}
+
+	// Swap in hierarchical components if requested and apply the cull distance
+	for (UInstancedStaticMeshComponent** component : { &m_floorStaticMeshComponent, &m_defaultWallStaticMeshComponent, &m_rotatedWallStaticMeshComponent }) {
+		FMazeMeshComponents::SetHierarchical(this, *component, bUseHierarchicalInstancing);
+		FMazeMeshComponents::SetCullDistance(*component, instanceCullDistance);
 	}
 
 	// Assign Static Meshes
@@ -76,58 +145,133 @@ void AATurn_MazeGen::GenerateMazeMeshes()
 		m_rotatedWallStaticMeshComponent->SetMaterial(0, m_rotatedWallInstancedMaterial);
 	}
 
-	// Loop through the grid and generate floor and walls
-	for (int x = 0; x < levelWidth; x++)
+	// Pick the seed. The same seed always gives the same maze.
+	if (bRandomizeSeed) {
+		seed = (int64(FMath::Rand()) << 32) ^ int64(FPlatformTime::Cycles64());
+	}
+	BeginSummary(bGenerateAsync);
+
+	if (bGenerateAsync) {
+		GenerateMazeMeshesAsync();
+		return m_summary;
+	}
+
+	// Choose which walls are rotated and build every transform, or take them from the cache
+	const FMazeGenCacheEntryPtr maze = FindOrBuildTurnMaze(levelWidth, levelHeight, uint64(seed), positionScaling, wallRotationDeg, meshScaling, floorMode,
+		bUseGenerationCache && !bRandomizeSeed, m_summary);
+
+	// Replace the previous maze, then one bulk add per component (world space, as the per-instance version used)
 	{
-		for (int y = 0; y < levelHeight; y++)
-		{
-			// Calculate Position
-			float xPos = x * positionScaling;
-			float yPos = y * positionScaling;
-			float zPos = 0; // Ground level
+		MAZEGEN_STAGE_SCOPE(STAT_MazeGen_AddInstances, m_summary.addInstancesMs);
+		FMazeInstanceBuffers::ClearFrom(m_floorStaticMeshComponent, m_defaultWallStaticMeshComponent, m_rotatedWallStaticMeshComponent);
+		maze->instances.AddTo(m_floorStaticMeshComponent, m_defaultWallStaticMeshComponent, m_rotatedWallStaticMeshComponent, true);
+	}
+	FinishSummary(maze->instances);
+
+	OnMazeGenerated.Broadcast();
+	return m_summary;
+}
 
-			FVector spawnLocation(xPos, yPos, zPos);
+void AATurn_MazeGen::BeginSummary(bool bAsync)
+{
+	if (m_summary.cellCount > 0) {
+		FMazeGenStats::RemoveMaze(m_summary);
+	}
+	m_summary = FMazeGenerationSummary();
+	m_summary.width = levelWidth;
+	m_summary.height = levelHeight;
+	m_summary.seed = seed;
+	m_summary.bAsync = bAsync;
+	m_summaryStartTime = FPlatformTime::Seconds();
+}
 
-			// Determine wall rotation (randomized)
-			int randValue = FMath::RandRange(0, 1);
-			FRotator wallRotation;
+/*===================
+FinishSummary
 
-			if (randValue == 1)
-			{
-				wallRotation = FRotator(0.0f, wallRotationDeg, 0.0f);
-			}
-			else
-			{
-				wallRotation = FRotator(0.0f, 0.0f, 0.0f);
-			}
+A turn maze has one wall per cell. The turn grid is dropped once the transforms are built, so
+no grid memory is counted.
+===================*/
+void AATurn_MazeGen::FinishSummary(const FMazeInstanceBuffers& instances)
+{
+	m_summary.cellCount = levelWidth * levelHeight;
+	m_summary.wallCount = m_summary.cellCount;
+	m_summary.wallInstanceCount = instances.defaultWalls.Num() + instances.rotatedWalls.Num();
+	m_summary.floorInstanceCount = instances.floors.Num();
+	m_summary.transformBytes = int64(instances.GetAllocatedSize());
+	m_summary.totalMs = float((FPlatformTime::Seconds() - m_summaryStartTime) * 1000.0);
+	FMazeGenStats::AddMaze(m_summary);
+	UE_LOG(LogTemp, Log, TEXT("Turn maze generated: %s"), *m_summary.ToString());
+}
 
-			// Define Scaling
-			FVector wallScale(1.0f * meshScaling.X, 0.1f * meshScaling.Y, 1.0f * meshScaling.Z);
-			FVector floorScale(1.0f * meshScaling.X, 1.0f * meshScaling.Y, 0.1f * meshScaling.Z);
 
-			// Create Transformations
-			FTransform wallTransform(wallRotation, spawnLocation, wallScale);
-			FTransform floorTransform(FRotator::ZeroRotator, spawnLocation, floorScale);
 
+/*===================
+GenerateMazeMeshesAsync
 
-			// Spawn Walls
-			if (randValue == 1)
-			{
-				m_rotatedWallStaticMeshComponent->AddInstance(wallTransform, true);
+Chooses the wall rotations and builds all instance transforms on a background thread, then
+adds the instances on the game thread. A shared cancellation flag lets CancelGeneration
+(or EndPlay) abandon the work.
+===================*/
+void AATurn_MazeGen::GenerateMazeMeshesAsync()
+{
+	// A new generation supersedes any that is still running
+	CancelGeneration();
+
+	TSharedPtr<MazeCore::FMazeCancelFlag, ESPMode::ThreadSafe> cancelToken = MakeShared<MazeCore::FMazeCancelFlag, ESPMode::ThreadSafe>(false);
+	m_cancelToken = cancelToken;
+
+	// Capture everything the worker needs by value; it must not touch the actor
+	TWeakObjectPtr<AATurn_MazeGen> weakThis(this);
+	const int32 width = levelWidth;
+	const int32 height = levelHeight;
+	const uint64 mazeSeed = uint64(seed);
+	const float cellSpacing = positionScaling;
+	const float rotationDeg = wallRotationDeg;
+	const FVector scaling = meshScaling;
+	const EMazeFloorMode mazeFloorMode = floorMode;
+
+	const bool bUseCache = bUseGenerationCache && !bRandomizeSeed;
+	const FMazeGenerationSummary startSummary = m_summary;
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [weakThis, cancelToken, width, height, mazeSeed, cellSpacing, rotationDeg, scaling, mazeFloorMode, bUseCache,
+		startSummary]()
+	{
+		FMazeGenerationSummary summary = startSummary;
+		const FMazeGenCacheEntryPtr result = FindOrBuildTurnMaze(width, height, mazeSeed, cellSpacing, rotationDeg, scaling, mazeFloorMode, bUseCache, summary,
+			cancelToken.Get());
+		if (!result.IsValid() || cancelToken->load()) {
+			return;
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [weakThis, cancelToken, result, summary]()
+		{
+			AATurn_MazeGen* maze = weakThis.Get();
+			if (!maze || cancelToken->load()) {
+				return;
 			}
-			else
+
+			// Replaces the previous maze, in world space like the synchronous AddInstance calls
+			maze->m_summary = summary;
 			{
-				m_defaultWallStaticMeshComponent->AddInstance(wallTransform, true);
+				MAZEGEN_STAGE_SCOPE(STAT_MazeGen_AddInstances, maze->m_summary.addInstancesMs);
+				FMazeInstanceBuffers::ClearFrom(maze->m_floorStaticMeshComponent, maze->m_defaultWallStaticMeshComponent, maze->m_rotatedWallStaticMeshComponent);
+				result->instances.AddTo(maze->m_floorStaticMeshComponent, maze->m_defaultWallStaticMeshComponent, maze->m_rotatedWallStaticMeshComponent, true);
 			}
+			maze->FinishSummary(result->instances);
+			maze->m_cancelToken.Reset();
+			maze->OnMazeGenerated.Broadcast();
+		});
+	});
+}
 
-			// Spawn Floor
-			m_floorStaticMeshComponent->AddInstance(floorTransform, true);
-		}
+void AATurn_MazeGen::CancelGeneration()
+{
+	if (m_cancelToken.IsValid()) {
+		m_cancelToken->store(true);
+		m_cancelToken.Reset();
 	}
 }
 
-
-
 // Called when the game starts or when spawned
 void AATurn_MazeGen::BeginPlay()
 {
@@ -138,6 +282,17 @@ void AATurn_MazeGen::BeginPlay()
 	GenerateMazeMeshes();
 }
 
+void AATurn_MazeGen::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelGeneration();
+	if (m_summary.cellCount > 0)
+	{
+		FMazeGenStats::RemoveMaze(m_summary);
+		m_summary = FMazeGenerationSummary();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void AATurn_MazeGen::Tick(float DeltaTime)
 {
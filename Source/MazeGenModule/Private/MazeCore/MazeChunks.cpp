@@ -0,0 +1,45 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Deterministic chunks of an unbounded maze.
+// License: MIT
+
+#include "MazeCore/MazeChunks.h"
+#include "MazeCore/MazeGenerators.h"
+
+namespace MazeCore
+{
+	// Salts keep the chunk interior and its two owned borders on separate random streams
+	static const uint64_t ChunkInteriorSalt = 0x43484E4B;
+	static const uint64_t ChunkWestBorderSalt = 0x57455354;
+	static const uint64_t ChunkSouthBorderSalt = 0x534F5554;
+
+	static uint64_t GetChunkSeed(uint64_t seed, int32_t chunkX, int32_t chunkY, uint64_t salt)
+	{
+		return MixSeed(MixSeed(MixSeed(seed, uint64_t(uint32_t(chunkX))), uint64_t(uint32_t(chunkY))), salt);
+	}
+
+	int32_t GetChunkBorderOpening(uint64_t seed, int32_t chunkX, int32_t chunkY, bool bWestBorder, int32_t chunkSize)
+	{
+		FMazeRandom random(GetChunkSeed(seed, chunkX, chunkY, bWestBorder ? ChunkWestBorderSalt : ChunkSouthBorderSalt));
+		return int32_t(random.NextBelow(uint32_t(chunkSize)));
+	}
+
+	/*===================
+	GenerateMazeChunk
+
+	Carves a perfect maze inside the chunk, then opens one cell on each border. A chunk owns its
+	west and south borders; the east and north openings come from the neighbouring chunks' west
+	and south borders, so both sides of every border agree.
+	===================*/
+	void GenerateMazeChunk(FMazeGrid& grid, uint64_t seed, int32_t chunkX, int32_t chunkY, int32_t chunkSize)
+	{
+		grid.Init(chunkSize, chunkSize);
+
+		FMazeRandom random(GetChunkSeed(seed, chunkX, chunkY, ChunkInteriorSalt));
+		GenerateIterativeBacktracker(grid, random, int32_t(random.NextBelow(uint32_t(chunkSize))), int32_t(random.NextBelow(uint32_t(chunkSize))));
+
+		grid.SetWestWall(0, GetChunkBorderOpening(seed, chunkX, chunkY, true, chunkSize), false);
+		grid.SetSouthWall(GetChunkBorderOpening(seed, chunkX, chunkY, false, chunkSize), 0, false);
+		grid.SetEastWall(chunkSize - 1, GetChunkBorderOpening(seed, chunkX + 1, chunkY, true, chunkSize), false);
+		grid.SetNorthWall(GetChunkBorderOpening(seed, chunkX, chunkY + 1, false, chunkSize), chunkSize - 1, false);
+	}
+}
@@ -0,0 +1,607 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeCorridorGraph
+// Purpose: A maze grid compressed to its junctions and dead ends.
+// License: MIT
+
+#include "MazeCore/MazeCorridorGraph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace MazeCore
+{
+	/*===================
+	FMazeCorridorGraph::Build
+
+	Scans the cells in row order. Every cell without exactly two open walls is a node, and the
+	corridors leaving it are walked cell by cell until the next node, so each corridor cell is
+	visited once from whichever of its two nodes is scanned first. Cells left over afterwards lie
+	on loops without a junction (only possible once walls have been removed by hand); one cell
+	of each such loop becomes a node so the loop is still searchable.
+	===================*/
+	void FMazeCorridorGraph::Build(const FMazeGrid& grid)
+	{
+		const int32_t cellCount = grid.GetCellCount();
+		const int32_t width = grid.GetWidth();
+		m_grid = &grid;
+		m_cellEdge.assign(size_t(cellCount), Unassigned);
+		m_cellOffset.assign(size_t(cellCount), 0);
+		m_nodeCells.clear();
+		m_links.clear();
+		m_edges.clear();
+		m_fieldSource = { -1, -1, 0 };
+
+		int32_t neighbors[4];
+		for (int32_t cell = 0; cell < cellCount; cell++)
+		{
+			if (m_cellEdge[cell] >= 0) {
+				continue;
+			}
+			const int32_t count = grid.GetOpenNeighbors(cell % width, cell / width, neighbors);
+			if (count == 2) {
+				continue;
+			}
+			const int32_t node = GetOrAddNode(cell);
+			for (int32_t i = 0; i < count; i++) {
+				WalkCorridor(node, neighbors[i]);
+			}
+		}
+
+		for (int32_t cell = 0; cell < cellCount; cell++)
+		{
+			if (m_cellEdge[cell] != Unassigned) {
+				continue;
+			}
+			const int32_t node = GetOrAddNode(cell);
+			const int32_t count = grid.GetOpenNeighbors(cell % width, cell / width, neighbors);
+			for (int32_t i = 0; i < count; i++) {
+				WalkCorridor(node, neighbors[i]);
+			}
+		}
+
+		BuildComponents();
+
+		// Stamps start below the epoch, so nothing reads as reached before the first query
+		const size_t nodeCount = m_nodeCells.size();
+		m_epoch = 1;
+		m_stamp.assign(nodeCount, 0);
+		m_distance.resize(nodeCount);
+		m_parent.resize(nodeCount);
+		m_stack.clear();
+		m_openHeap.clear();
+		m_openHeap.reserve(1024);
+	}
+
+	int32_t FMazeCorridorGraph::GetOrAddNode(int32_t cell)
+	{
+		const int32_t code = m_cellEdge[cell];
+		if (code < 0 && code != Unassigned) {
+			return DecodeNode(code);
+		}
+		const int32_t node = int32_t(m_nodeCells.size());
+		m_nodeCells.push_back(cell);
+		m_links.insert(m_links.end(), MaxNodeLinks, FLink{ -1, 0, 0 });
+		m_cellEdge[cell] = EncodeNode(node);
+		return node;
+	}
+
+	void FMazeCorridorGraph::AddLink(int32_t node, const FLink& link)
+	{
+		FLink* links = &m_links[size_t(node) * MaxNodeLinks];
+		for (int32_t i = 0; i < MaxNodeLinks; i++)
+		{
+			if (links[i].node < 0) {
+				links[i] = link;
+				return;
+			}
+		}
+	}
+
+	void FMazeCorridorGraph::WalkCorridor(int32_t node, int32_t firstCell)
+	{
+		const int32_t width = m_grid->GetWidth();
+		const int32_t from = m_nodeCells[node];
+		int32_t neighbors[4];
+
+		// Already walked from its other end
+		if (m_cellEdge[firstCell] >= 0) {
+			return;
+		}
+
+		// Two neighbouring nodes share a one step edge, added by the one with the lower cell index
+		if (firstCell < from && (m_cellEdge[firstCell] != Unassigned || m_grid->GetOpenNeighbors(firstCell % width, firstCell / width, neighbors) != 2)) {
+			return;
+		}
+
+		const int32_t edgeIndex = int32_t(m_edges.size());
+		int32_t previous = from;
+		int32_t cell = firstCell;
+		int32_t length = 1;
+		while (m_cellEdge[cell] == Unassigned && m_grid->GetOpenNeighbors(cell % width, cell / width, neighbors) == 2)
+		{
+			m_cellEdge[cell] = edgeIndex;
+			m_cellOffset[cell] = length;
+			const int32_t next = neighbors[0] == previous ? neighbors[1] : neighbors[0];
+			previous = cell;
+			cell = next;
+			length++;
+		}
+
+		const int32_t endNode = GetOrAddNode(cell);
+		m_edges.push_back({ node, endNode, length, firstCell, previous });
+		AddLink(node, { endNode, length, edgeIndex << 1 | 1 });
+		AddLink(endNode, { node, length, edgeIndex << 1 });
+	}
+
+	/*===================
+	FMazeCorridorGraph::BuildComponents
+
+	Depth-first labelling over the links. A graph is a forest exactly when it has one edge fewer
+	than nodes per component.
+	===================*/
+	void FMazeCorridorGraph::BuildComponents()
+	{
+		const int32_t nodeCount = GetNodeCount();
+		m_nodeComponents.assign(size_t(nodeCount), -1);
+
+		int32_t componentCount = 0;
+		for (int32_t root = 0; root < nodeCount; root++)
+		{
+			if (m_nodeComponents[root] >= 0) {
+				continue;
+			}
+			m_nodeComponents[root] = componentCount;
+			m_stack.push_back(root);
+			while (!m_stack.empty())
+			{
+				const FLink* links = GetLinks(m_stack.back());
+				m_stack.pop_back();
+				for (int32_t i = 0; i < MaxNodeLinks && links[i].node >= 0; i++)
+				{
+					if (m_nodeComponents[links[i].node] < 0) {
+						m_nodeComponents[links[i].node] = componentCount;
+						m_stack.push_back(links[i].node);
+					}
+				}
+			}
+			componentCount++;
+		}
+		m_bForest = GetEdgeCount() == nodeCount - componentCount;
+	}
+
+	size_t FMazeCorridorGraph::GetAllocatedSize() const
+	{
+		return (m_cellEdge.capacity() + m_cellOffset.capacity() + m_nodeCells.capacity() + m_nodeComponents.capacity()
+				+ m_distance.capacity() + m_parent.capacity() + m_stack.capacity()) * sizeof(int32_t)
+			+ m_links.capacity() * sizeof(FLink) + m_edges.capacity() * sizeof(FEdge) + m_stamp.capacity() * sizeof(uint32_t)
+			+ m_openHeap.capacity() * sizeof(uint64_t);
+	}
+
+	FMazeCorridorGraph::FLocation FMazeCorridorGraph::Locate(int32_t cell) const
+	{
+		const int32_t code = m_cellEdge[cell];
+		if (code < 0) {
+			return { DecodeNode(code), -1, 0 };
+		}
+		return { -1, code, m_cellOffset[cell] };
+	}
+
+	int32_t FMazeCorridorGraph::GetComponent(const FLocation& location) const
+	{
+		return m_nodeComponents[location.node >= 0 ? location.node : m_edges[location.edge].nodeA];
+	}
+
+	bool FMazeCorridorGraph::IsReachable(int32_t startX, int32_t startY, int32_t goalX, int32_t goalY) const
+	{
+		return GetComponent(Locate(m_grid->GetCellIndex(startX, startY))) == GetComponent(Locate(m_grid->GetCellIndex(goalX, goalY)));
+	}
+
+	int32_t FMazeCorridorGraph::StepAlongEdge(const FEdge& edge, int32_t cell, int32_t offset, int32_t direction) const
+	{
+		if (offset == 0) {
+			return edge.firstCell;
+		}
+		if (offset == edge.length) {
+			return edge.lastCell;
+		}
+		const int32_t target = offset + direction;
+		if (target == 0) {
+			return m_nodeCells[edge.nodeA];
+		}
+		if (target == edge.length) {
+			return m_nodeCells[edge.nodeB];
+		}
+
+		// Inside a corridor both neighbours lie on the same edge, one offset either side
+		const int32_t width = m_grid->GetWidth();
+		int32_t neighbors[4];
+		const int32_t count = m_grid->GetOpenNeighbors(cell % width, cell / width, neighbors);
+		for (int32_t i = 0; i < count; i++)
+		{
+			if (m_cellEdge[neighbors[i]] >= 0 && m_cellOffset[neighbors[i]] == target) {
+				return neighbors[i];
+			}
+		}
+		return -1;
+	}
+
+	bool FMazeCorridorGraph::AppendEdgeCells(int32_t edgeIndex, int32_t fromOffset, int32_t toOffset, std::vector<int32_t>& outPath) const
+	{
+		const FEdge& edge = m_edges[edgeIndex];
+		const int32_t direction = toOffset > fromOffset ? 1 : -1;
+		int32_t cell = outPath.back();
+		for (int32_t offset = fromOffset; offset != toOffset; offset += direction)
+		{
+			cell = StepAlongEdge(edge, cell, offset, direction);
+			if (cell < 0) {
+				return false;
+			}
+			outPath.push_back(cell);
+		}
+		return true;
+	}
+
+	void FMazeCorridorGraph::BeginQuery()
+	{
+		// On wrap-around clear the stamps once so no stale entry can match the new epoch
+		if (++m_epoch == 0) {
+			std::fill(m_stamp.begin(), m_stamp.end(), 0);
+			m_epoch = 1;
+		}
+		m_stack.clear();
+		m_openHeap.clear();
+	}
+
+	int32_t FMazeCorridorGraph::GetGoalDistance(int32_t node, int32_t distance, const FLocation& goal, int32_t& outOffset) const
+	{
+		if (node == goal.node) {
+			outOffset = 0;
+			return distance;
+		}
+		if (goal.edge < 0) {
+			return Unreached;
+		}
+
+		// A corridor in a loop can have the node at both ends
+		const FEdge& edge = m_edges[goal.edge];
+		int32_t best = Unreached;
+		if (node == edge.nodeA) {
+			best = distance + goal.offset;
+			outOffset = 0;
+		}
+		if (node == edge.nodeB && distance + edge.length - goal.offset < best) {
+			best = distance + edge.length - goal.offset;
+			outOffset = edge.length;
+		}
+		return best;
+	}
+
+	int32_t FMazeCorridorGraph::GetHeuristic(int32_t node, int32_t goalCell) const
+	{
+		const int32_t width = m_grid->GetWidth();
+		const int32_t dx = m_nodeCells[node] % width - goalCell % width;
+		const int32_t dy = m_nodeCells[node] / width - goalCell / width;
+		return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+	}
+
+	/*===================
+	FMazeCorridorGraph::SearchForest
+
+	Greedy best-first: the open list is ordered by the Manhattan distance to the goal alone, since
+	the first way a search finds into a tree node is the only one. Dead ends are given their
+	distance but never queued, as their single edge leads back the way the search came.
+	===================*/
+	void FMazeCorridorGraph::SearchForest(const FLocation& start, const FLocation& goal, int32_t goalCell, int32_t& inOutBest, int32_t& outNode, int32_t& outOffset)
+	{
+		BeginQuery();
+		auto reach = [&](int32_t node, int32_t distance, int32_t parent, bool bExpand)
+		{
+			Visit(node, distance, parent);
+			int32_t offset = 0;
+			const int32_t goalDistance = GetGoalDistance(node, distance, goal, offset);
+			if (goalDistance < inOutBest) {
+				inOutBest = goalDistance;
+				outNode = node;
+				outOffset = offset;
+				return true;
+			}
+			if (bExpand) {
+				m_openHeap.push_back(uint64_t(uint32_t(GetHeuristic(node, goalCell))) << 32 | uint32_t(node));
+				std::push_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+			}
+			return false;
+		};
+
+		if (start.node >= 0)
+		{
+			if (reach(start.node, 0, -1, true)) {
+				return;
+			}
+		}
+		else
+		{
+			const FEdge& edge = m_edges[start.edge];
+			if (reach(edge.nodeA, start.offset, -1, !IsDeadEnd(edge.nodeA)) || reach(edge.nodeB, edge.length - start.offset, -2, !IsDeadEnd(edge.nodeB))) {
+				return;
+			}
+		}
+
+		while (!m_openHeap.empty())
+		{
+			std::pop_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+			const int32_t node = int32_t(uint32_t(m_openHeap.back()));
+			m_openHeap.pop_back();
+
+			const int32_t distance = m_distance[node];
+			const FLink* links = GetLinks(node);
+			for (int32_t i = 0; i < MaxNodeLinks && links[i].node >= 0; i++)
+			{
+				const FLink& link = links[i];
+				if (!IsCurrent(link.node) && reach(link.node, distance + link.length, link.parent, !IsDeadEnd(link.node))) {
+					return;
+				}
+			}
+		}
+	}
+
+	/*===================
+	FMazeCorridorGraph::SearchGraph
+
+	A* for graphs with loops. Open list entries pack the estimated total cost above the node index;
+	entries left behind by a shorter distance are skipped when popped. The search stops once the
+	smallest estimate can no longer beat the best complete path.
+	===================*/
+	void FMazeCorridorGraph::SearchGraph(const FLocation& start, const FLocation& goal, int32_t goalCell, int32_t& inOutBest, int32_t& outNode, int32_t& outOffset)
+	{
+		BeginQuery();
+		auto push = [&](int32_t node, int32_t distance, int32_t parent)
+		{
+			if (IsCurrent(node) && distance >= m_distance[node]) {
+				return;
+			}
+			Visit(node, distance, parent);
+			m_openHeap.push_back(uint64_t(uint32_t(distance + GetHeuristic(node, goalCell))) << 32 | uint32_t(node));
+			std::push_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+		};
+
+		if (start.node >= 0) {
+			push(start.node, 0, -1);
+		}
+		else {
+			const FEdge& edge = m_edges[start.edge];
+			push(edge.nodeA, start.offset, -1);
+			push(edge.nodeB, edge.length - start.offset, -2);
+		}
+
+		while (!m_openHeap.empty() && int32_t(m_openHeap.front() >> 32) < inOutBest)
+		{
+			std::pop_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+			const uint64_t entry = m_openHeap.back();
+			m_openHeap.pop_back();
+
+			const int32_t node = int32_t(uint32_t(entry));
+			const int32_t distance = m_distance[node];
+			if (int32_t(entry >> 32) != distance + GetHeuristic(node, goalCell)) {
+				continue;
+			}
+
+			int32_t offset = 0;
+			const int32_t goalDistance = GetGoalDistance(node, distance, goal, offset);
+			if (goalDistance < inOutBest) {
+				inOutBest = goalDistance;
+				outNode = node;
+				outOffset = offset;
+			}
+
+			const FLink* links = GetLinks(node);
+			for (int32_t i = 0; i < MaxNodeLinks && links[i].node >= 0; i++) {
+				push(links[i].node, distance + links[i].length, links[i].parent);
+			}
+		}
+	}
+
+	/*===================
+	FMazeCorridorGraph::FindPath
+
+	A start or goal inside a corridor is joined to the nodes at both of its ends, and when both
+	share a corridor the direct walk along it is the first candidate. The path is rebuilt from the
+	node parents and expanded back into cells corridor by corridor. Expanding reads the grid, so a
+	wall closed since Build breaks the path and the query fails rather than return a broken one.
+	===================*/
+	int32_t FMazeCorridorGraph::FindPath(int32_t startX, int32_t startY, int32_t goalX, int32_t goalY, std::vector<int32_t>& outPath)
+	{
+		outPath.clear();
+		const int32_t startCell = m_grid->GetCellIndex(startX, startY);
+		const int32_t goalCell = m_grid->GetCellIndex(goalX, goalY);
+		const FLocation start = Locate(startCell);
+		const FLocation goal = Locate(goalCell);
+		if (GetComponent(start) != GetComponent(goal)) {
+			return -1;
+		}
+
+		int32_t best = Unreached;
+		int32_t bestNode = -1;
+		int32_t bestOffset = 0;
+		if (startCell == goalCell) {
+			best = 0;
+		}
+		else if (start.edge >= 0 && start.edge == goal.edge) {
+			best = std::abs(start.offset - goal.offset);
+		}
+
+		// In a tree the direct walk along a shared corridor is the only path
+		if (!m_bForest) {
+			SearchGraph(start, goal, goalCell, best, bestNode, bestOffset);
+		}
+		else if (best == Unreached) {
+			SearchForest(start, goal, goalCell, best, bestNode, bestOffset);
+		}
+		if (best == Unreached) {
+			return -1;
+		}
+
+		// Built backwards from the goal, then reversed
+		outPath.push_back(goalCell);
+		bool bExpanded = true;
+		if (bestNode < 0) {
+			if (goalCell != startCell) {
+				bExpanded = AppendEdgeCells(goal.edge, goal.offset, start.offset, outPath);
+			}
+		}
+		else
+		{
+			if (goal.edge >= 0) {
+				bExpanded = AppendEdgeCells(goal.edge, goal.offset, bestOffset, outPath);
+			}
+			int32_t node = bestNode;
+			while (bExpanded && m_parent[node] >= 0)
+			{
+				const int32_t edgeIndex = m_parent[node] >> 1;
+				const FEdge& edge = m_edges[edgeIndex];
+				const bool bReachedAtB = (m_parent[node] & 1) != 0;
+				bExpanded = AppendEdgeCells(edgeIndex, bReachedAtB ? edge.length : 0, bReachedAtB ? 0 : edge.length, outPath);
+				node = bReachedAtB ? edge.nodeA : edge.nodeB;
+			}
+			if (bExpanded && start.edge >= 0) {
+				bExpanded = AppendEdgeCells(start.edge, m_parent[node] == -2 ? m_edges[start.edge].length : 0, start.offset, outPath);
+			}
+		}
+		if (!bExpanded)
+		{
+			outPath.clear();
+			return -1;
+		}
+		std::reverse(outPath.begin(), outPath.end());
+		return best;
+	}
+
+	/*===================
+	FMazeCorridorGraph::ComputeDistanceField
+
+	On a forest every node is reached exactly once whatever the order, so a plain stack does and
+	dead ends are never pushed. Graphs with loops need Dijkstra's ordering.
+	===================*/
+	void FMazeCorridorGraph::ComputeDistanceField(int32_t x, int32_t y)
+	{
+		m_fieldSource = Locate(m_grid->GetCellIndex(x, y));
+		BeginQuery();
+
+		if (m_bForest)
+		{
+			if (m_fieldSource.node >= 0) {
+				Visit(m_fieldSource.node, 0, -1);
+				m_stack.push_back(m_fieldSource.node);
+			}
+			else {
+				const FEdge& edge = m_edges[m_fieldSource.edge];
+				Visit(edge.nodeA, m_fieldSource.offset, -1);
+				Visit(edge.nodeB, edge.length - m_fieldSource.offset, -2);
+				m_stack.push_back(edge.nodeA);
+				m_stack.push_back(edge.nodeB);
+			}
+
+			while (!m_stack.empty())
+			{
+				const int32_t node = m_stack.back();
+				m_stack.pop_back();
+				const int32_t distance = m_distance[node];
+				const FLink* links = GetLinks(node);
+				for (int32_t i = 0; i < MaxNodeLinks && links[i].node >= 0; i++)
+				{
+					const FLink& link = links[i];
+					if (!IsCurrent(link.node)) {
+						Visit(link.node, distance + link.length, link.parent);
+						if (!IsDeadEnd(link.node)) {
+							m_stack.push_back(link.node);
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		auto push = [this](int32_t node, int32_t distance, int32_t parent)
+		{
+			if (IsCurrent(node) && distance >= m_distance[node]) {
+				return;
+			}
+			Visit(node, distance, parent);
+			m_openHeap.push_back(uint64_t(uint32_t(distance)) << 32 | uint32_t(node));
+			std::push_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+		};
+		if (m_fieldSource.node >= 0) {
+			push(m_fieldSource.node, 0, -1);
+		}
+		else {
+			const FEdge& edge = m_edges[m_fieldSource.edge];
+			push(edge.nodeA, m_fieldSource.offset, -1);
+			push(edge.nodeB, edge.length - m_fieldSource.offset, -2);
+		}
+		while (!m_openHeap.empty())
+		{
+			std::pop_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+			const uint64_t entry = m_openHeap.back();
+			m_openHeap.pop_back();
+
+			const int32_t node = int32_t(uint32_t(entry));
+			const int32_t distance = m_distance[node];
+			if (int32_t(entry >> 32) != distance) {
+				continue;
+			}
+			const FLink* links = GetLinks(node);
+			for (int32_t i = 0; i < MaxNodeLinks && links[i].node >= 0; i++) {
+				push(links[i].node, distance + links[i].length, links[i].parent);
+			}
+		}
+	}
+
+	/*===================
+	FMazeCorridorGraph::GetCellDistance
+
+	A node's distance was settled by the last search. A corridor cell is reached through the
+	closer of its two ends, or directly when the source lies on the same corridor.
+	===================*/
+	int32_t FMazeCorridorGraph::GetCellDistance(int32_t cell) const
+	{
+		const FLocation location = Locate(cell);
+		if (location.node >= 0) {
+			return IsCurrent(location.node) ? m_distance[location.node] : -1;
+		}
+
+		const FEdge& edge = m_edges[location.edge];
+		int32_t best = Unreached;
+		if (m_fieldSource.edge == location.edge) {
+			best = std::abs(m_fieldSource.offset - location.offset);
+		}
+		if (IsCurrent(edge.nodeA)) {
+			best = std::min(best, m_distance[edge.nodeA] + location.offset);
+		}
+		if (IsCurrent(edge.nodeB)) {
+			best = std::min(best, m_distance[edge.nodeB] + edge.length - location.offset);
+		}
+		return best == Unreached ? -1 : best;
+	}
+
+	int32_t FMazeCorridorGraph::GetDistance(int32_t x, int32_t y) const
+	{
+		return GetCellDistance(m_grid->GetCellIndex(x, y));
+	}
+
+	int32_t FMazeCorridorGraph::GetStepToFieldSource(int32_t x, int32_t y) const
+	{
+		const int32_t distance = GetDistance(x, y);
+		if (distance <= 0) {
+			return -1;
+		}
+		int32_t neighbors[4];
+		const int32_t count = m_grid->GetOpenNeighbors(x, y, neighbors);
+		for (int32_t i = 0; i < count; i++)
+		{
+			if (GetCellDistance(neighbors[i]) == distance - 1) {
+				return neighbors[i];
+			}
+		}
+		return -1;
+	}
+}
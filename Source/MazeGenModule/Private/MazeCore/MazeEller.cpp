@@ -0,0 +1,168 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeEllerGenerator
+// Purpose: Eller's algorithm, which builds a perfect maze one row at a time.
+// License: MIT
+
+#include "MazeCore/MazeEller.h"
+
+namespace MazeCore
+{
+	static void SetRowBit(std::vector<uint64_t>& bits, int32_t x, bool bValue)
+	{
+		const uint64_t mask = uint64_t(1) << (x & 63);
+		bits[x >> 6] = bValue ? (bits[x >> 6] | mask) : (bits[x >> 6] & ~mask);
+	}
+
+	void FMazeEllerGenerator::Init(int32_t width, uint64_t seed)
+	{
+		m_width = width;
+		m_nextRow = 0;
+		m_random.Seed(seed);
+
+		m_row.y = 0;
+		m_row.westWalls.assign(size_t(width + 1 + 63) / 64, 0);
+		m_row.northWalls.assign(size_t(width + 63) / 64, 0);
+
+		// Every cell of the first row starts in a set of its own
+		m_cellSets.resize(size_t(width));
+		for (int32_t x = 0; x < width; x++) {
+			m_cellSets[x] = x;
+		}
+		m_setParent.resize(size_t(width));
+		m_setCellCount.resize(size_t(width));
+		m_setChosenCell.resize(size_t(width));
+		m_setFlag.resize(size_t(width));
+	}
+
+	size_t FMazeEllerGenerator::GetAllocatedSize() const
+	{
+		return (m_row.westWalls.capacity() + m_row.northWalls.capacity()) * sizeof(uint64_t)
+			+ (m_cellSets.capacity() + m_setParent.capacity() + m_setCellCount.capacity() + m_setChosenCell.capacity()) * sizeof(int32_t)
+			+ m_setFlag.capacity();
+	}
+
+	int32_t FMazeEllerGenerator::FindSet(int32_t set)
+	{
+		while (m_setParent[set] != set) {
+			m_setParent[set] = m_setParent[m_setParent[set]];
+			set = m_setParent[set];
+		}
+		return set;
+	}
+
+	/*===================
+	FMazeEllerGenerator::NextRow
+
+	1. Randomly joins neighbouring cells that are in different sets (all of them on the last row).
+	   Joined sets are merged with a union-find over the set ids, so a merge costs O(1) rather
+	   than relabelling the row.
+	2. Picks at least one cell of every set to open north, so no set is cut off. Each cell opens
+	   with a coin flip, and sets left without an opening open at one of their cells chosen at random.
+	3. Cells that opened north carry their set into the next row; the others get unused set ids.
+	Every step is a linear pass over the row.
+	===================*/
+	const FMazeRowWalls& FMazeEllerGenerator::NextRow(bool bLastRow)
+	{
+		const int32_t width = m_width;
+		m_row.y = m_nextRow++;
+
+		// Step 1: join neighbours in different sets
+		for (int32_t set = 0; set < width; set++) {
+			m_setParent[set] = set;
+		}
+		SetRowBit(m_row.westWalls, 0, true);
+		SetRowBit(m_row.westWalls, width, true);
+		for (int32_t x = 0; x + 1 < width; x++)
+		{
+			const int32_t leftSet = FindSet(m_cellSets[x]);
+			const int32_t rightSet = FindSet(m_cellSets[x + 1]);
+			const bool bJoin = leftSet != rightSet && (bLastRow || m_random.RandBool());
+			if (bJoin) {
+				m_setParent[rightSet] = leftSet;
+			}
+			SetRowBit(m_row.westWalls, x + 1, !bJoin);
+		}
+		for (int32_t x = 0; x < width; x++) {
+			m_cellSets[x] = FindSet(m_cellSets[x]);
+		}
+
+		// The last row has nothing above it
+		if (bLastRow) {
+			for (uint64_t& word : m_row.northWalls) {
+				word = ~uint64_t(0);
+			}
+			return m_row;
+		}
+
+		// Step 2: open cells north at random, then give each set that got no opening one at a cell
+		// chosen uniformly among its cells (reservoir sampling over just those sets)
+		for (int32_t set = 0; set < width; set++) {
+			m_setCellCount[set] = 0;
+			m_setFlag[set] = 0;
+		}
+		for (int32_t x = 0; x < width; x++) {
+			const bool bOpen = m_random.RandBool();
+			SetRowBit(m_row.northWalls, x, !bOpen);
+			m_setFlag[m_cellSets[x]] |= uint8_t(bOpen);
+		}
+		for (int32_t x = 0; x < width; x++) {
+			const int32_t set = m_cellSets[x];
+			if (!m_setFlag[set] && m_random.NextBelow(uint32_t(++m_setCellCount[set])) == 0) {
+				m_setChosenCell[set] = x;
+			}
+		}
+		for (int32_t x = 0; x < width; x++) {
+			const int32_t set = m_cellSets[x];
+			if (!m_setFlag[set] && m_setChosenCell[set] == x) {
+				SetRowBit(m_row.northWalls, x, false);
+			}
+		}
+
+		// Step 3: carry sets through the openings, and give every other cell of the next row a fresh set.
+		// m_setFlag now marks the set ids still in use.
+		for (int32_t set = 0; set < width; set++) {
+			m_setFlag[set] = 0;
+		}
+		for (int32_t x = 0; x < width; x++) {
+			if (!m_row.HasNorthWall(x)) {
+				m_setFlag[m_cellSets[x]] = 1;
+			}
+		}
+		int32_t freeSet = 0;
+		for (int32_t x = 0; x < width; x++)
+		{
+			if (m_row.HasNorthWall(x)) {
+				while (m_setFlag[freeSet]) {
+					freeSet++;
+				}
+				m_setFlag[freeSet] = 1;
+				m_cellSets[x] = freeSet;
+			}
+		}
+		return m_row;
+	}
+
+	void GenerateEllerMaze(int32_t width, int32_t height, uint64_t seed, const std::function<void(const FMazeRowWalls&)>& consumer,
+		const FMazeCancelFlag* cancel)
+	{
+		FMazeEllerGenerator generator;
+		generator.Init(width, seed);
+		for (int32_t y = 0; y < height; y++)
+		{
+			if ((y & 63) == 0 && cancel && cancel->load(std::memory_order_relaxed)) {
+				return;
+			}
+			consumer(generator.NextRow(y == height - 1));
+		}
+	}
+
+	void ApplyMazeRow(FMazeGrid& grid, const FMazeRowWalls& row)
+	{
+		for (int32_t x = 0; x < grid.GetWidth(); x++) {
+			grid.SetWestWall(x, row.y, row.HasWestWall(x));
+			grid.SetNorthWall(x, row.y, row.HasNorthWall(x));
+			grid.SetVisited(x, row.y);
+		}
+		grid.SetEastWall(grid.GetWidth() - 1, row.y, row.HasEastWall(grid.GetWidth() - 1));
+	}
+}
@@ -0,0 +1,299 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeFileHeader
+// Purpose: Binary maze file format.
+// License: MIT
+
+#include "MazeCore/MazeFile.h"
+#include "MazeCore/MazeEller.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <utility>
+
+namespace MazeCore
+{
+	/*===================
+	GetMazeFileWordsPerRow
+
+	Rows are padded to whole 64-bit words, the same as FMazeGrid::Init.
+	===================*/
+	static int32_t GetMazeFileWordsPerRow(const FMazeFileHeader& header)
+	{
+		return int32_t((int64_t(header.width) + 1 + 63) / 64);
+	}
+
+	// Rows of each wall plane. In 64 bits, as a header can hold any height before it is checked.
+	static int64_t GetMazeFileRowCount(const FMazeFileHeader& header)
+	{
+		return int64_t(header.height) + 1;
+	}
+
+	static bool IsCellInMaze(const FMazeFileHeader& header, int32_t x, int32_t y)
+	{
+		return x >= 0 && y >= 0 && x < header.width && y < header.height;
+	}
+
+	static FMazeFileHeader MakeMazeFileHeader(int32_t width, int32_t height, uint64_t seed, EMazeGenAlgorithm algorithm, const FMazeEndpoints& endpoints,
+		int32_t sectionRows)
+	{
+		FMazeFileHeader header = {};
+		header.magic = MazeFileMagic;
+		header.version = MazeFileVersion;
+		header.width = width;
+		header.height = height;
+		header.seed = seed;
+		header.algorithm = uint32_t(algorithm);
+		header.flags = endpoints.bExitOnRightEdge ? 1u : 0u;
+		header.startX = endpoints.startX;
+		header.startY = endpoints.startY;
+		header.exitX = endpoints.exitX;
+		header.exitY = endpoints.exitY;
+		header.sectionRows = std::max(sectionRows, 1);
+		return header;
+	}
+
+	FMazeFileHeader MakeMazeFileHeader(const FMazeGrid& grid, uint64_t seed, EMazeGenAlgorithm algorithm, const FMazeEndpoints& endpoints, int32_t sectionRows)
+	{
+		FMazeFileHeader header = MakeMazeFileHeader(grid.GetWidth(), grid.GetHeight(), seed, algorithm, endpoints, sectionRows);
+		header.wallHash = grid.ComputeWallHash();
+		return header;
+	}
+
+	size_t GetMazeFileSize(const FMazeFileHeader& header)
+	{
+		return sizeof(FMazeFileHeader) + size_t(GetMazeFileRowCount(header)) * size_t(GetMazeFileWordsPerRow(header)) * 2 * sizeof(uint64_t);
+	}
+
+	int32_t GetMazeFileSectionCount(const FMazeFileHeader& header)
+	{
+		return int32_t((GetMazeFileRowCount(header) + header.sectionRows - 1) / header.sectionRows);
+	}
+
+	FMazeEndpoints GetMazeFileEndpoints(const FMazeFileHeader& header)
+	{
+		FMazeEndpoints endpoints;
+		endpoints.startX = header.startX;
+		endpoints.startY = header.startY;
+		endpoints.exitX = header.exitX;
+		endpoints.exitY = header.exitY;
+		endpoints.bExitOnRightEdge = (header.flags & 1u) != 0;
+		return endpoints;
+	}
+
+	void WriteMazeFile(const FMazeGrid& grid, const FMazeFileHeader& header, uint8_t* outData)
+	{
+		std::memcpy(outData, &header, sizeof(header));
+
+		const size_t rowBytes = size_t(grid.GetWordsPerRow()) * sizeof(uint64_t);
+		const int32_t rowCount = grid.GetHeight() + 1;
+		uint8_t* section = outData + sizeof(header);
+		for (int32_t firstRow = 0; firstRow < rowCount; firstRow += header.sectionRows)
+		{
+			const size_t rows = size_t(std::min(header.sectionRows, rowCount - firstRow));
+			std::memcpy(section, grid.GetSouthWallWords() + size_t(firstRow) * grid.GetWordsPerRow(), rows * rowBytes);
+			std::memcpy(section + rows * rowBytes, grid.GetWestWallWords() + size_t(firstRow) * grid.GetWordsPerRow(), rows * rowBytes);
+			section += 2 * rows * rowBytes;
+		}
+	}
+
+	bool ReadMazeFileHeader(const uint8_t* data, size_t size, FMazeFileHeader& outHeader)
+	{
+		if (data == nullptr || size < sizeof(FMazeFileHeader)) {
+			return false;
+		}
+		std::memcpy(&outHeader, data, sizeof(outHeader));
+
+		// Cell indices are int32, so the cell count has to fit one, and so does a row padded to whole words
+		if (outHeader.magic != MazeFileMagic || outHeader.version != MazeFileVersion || outHeader.width <= 0 || outHeader.height <= 0
+			|| int64_t(outHeader.width) * outHeader.height > INT32_MAX || outHeader.width > INT32_MAX - 64 || outHeader.height > INT32_MAX - 64
+			|| outHeader.sectionRows <= 0) {
+			return false;
+		}
+
+		// The solvers index the grid with the entrance and exit straight from the header
+		if (!IsCellInMaze(outHeader, outHeader.startX, outHeader.startY) || !IsCellInMaze(outHeader, outHeader.exitX, outHeader.exitY)) {
+			return false;
+		}
+		return size >= GetMazeFileSize(outHeader);
+	}
+
+	void ReadMazeFileSection(const uint8_t* data, const FMazeFileHeader& header, int32_t section, FMazeGrid& grid)
+	{
+		const size_t rowBytes = size_t(GetMazeFileWordsPerRow(header)) * sizeof(uint64_t);
+		const int32_t firstRow = section * header.sectionRows;
+		const size_t rows = size_t(std::min(int64_t(header.sectionRows), GetMazeFileRowCount(header) - firstRow));
+
+		// Every section before this one is full
+		const uint8_t* source = data + sizeof(FMazeFileHeader) + size_t(firstRow) * 2 * rowBytes;
+		std::memcpy(grid.GetSouthWallWords() + size_t(firstRow) * grid.GetWordsPerRow(), source, rows * rowBytes);
+		std::memcpy(grid.GetWestWallWords() + size_t(firstRow) * grid.GetWordsPerRow(), source + rows * rowBytes, rows * rowBytes);
+	}
+
+	/*===================
+	ReadMazeFile
+
+	Reads into a grid of its own and only moves it into outGrid once the hash has been checked,
+	so a corrupt file leaves the caller's maze as it was.
+	===================*/
+	bool ReadMazeFile(const uint8_t* data, size_t size, FMazeGrid& outGrid, FMazeFileHeader& outHeader, bool bVerifyHash)
+	{
+		FMazeFileHeader header;
+		if (!ReadMazeFileHeader(data, size, header)) {
+			return false;
+		}
+
+		FMazeGrid grid;
+		grid.Init(header.width, header.height);
+		const int32_t sectionCount = GetMazeFileSectionCount(header);
+		for (int32_t section = 0; section < sectionCount; section++) {
+			ReadMazeFileSection(data, header, section, grid);
+		}
+		if (bVerifyHash && grid.ComputeWallHash() != header.wallHash) {
+			return false;
+		}
+
+		outGrid = std::move(grid);
+		outHeader = header;
+		return true;
+	}
+
+	/*===================
+	CopyEllerRowBits
+
+	Copies bitCount bits of a row into a plane line and sets every bit past them, the way
+	FMazeGrid::Init leaves the bits a generator never writes
+	===================*/
+	static void CopyEllerRowBits(const std::vector<uint64_t>& bits, int32_t bitCount, std::vector<uint64_t>& outLine)
+	{
+		for (size_t i = 0; i < outLine.size(); i++)
+		{
+			const int64_t firstBit = int64_t(i) * 64;
+			const uint64_t padding = bitCount >= firstBit + 64 ? 0 : (bitCount <= firstBit ? ~uint64_t(0) : ~uint64_t(0) << (bitCount - firstBit));
+			outLine[i] = (i < bits.size() ? bits[i] : 0) | padding;
+		}
+	}
+
+	static void ClearLineBit(std::vector<uint64_t>& line, int32_t x)
+	{
+		line[x >> 6] &= ~(uint64_t(1) << (x & 63));
+	}
+
+	/*===================
+	ForEachEllerPlaneLine
+
+	Line y of the planes holds the south walls under row y, which are the north walls of row y - 1,
+	and the west walls of row y. So line y is complete once row y is carved, and the lines come out
+	in file order with only one row kept. The entrance and exit are opened as OpenEndpoints would.
+	===================*/
+	template <typename LineFunc>
+	static bool ForEachEllerPlaneLine(int32_t width, int32_t height, uint64_t ellerSeed, const FMazeEndpoints& endpoints, int32_t wordsPerRow,
+		const FMazeCancelFlag* cancel, LineFunc&& lineFunc)
+	{
+		// The bottom border is closed
+		std::vector<uint64_t> southLine(size_t(wordsPerRow), ~uint64_t(0));
+		std::vector<uint64_t> westLine(size_t(wordsPerRow), ~uint64_t(0));
+
+		FMazeEllerGenerator generator;
+		generator.Init(width, ellerSeed);
+		for (int32_t line = 0; line <= height; line++)
+		{
+			if ((line & 63) == 0 && cancel && cancel->load(std::memory_order_relaxed)) {
+				return false;
+			}
+
+			// The top line has only the north border, with no row above it
+			const FMazeRowWalls* row = nullptr;
+			if (line < height)
+			{
+				row = &generator.NextRow(line == height - 1);
+				CopyEllerRowBits(row->westWalls, width + 1, westLine);
+				if (line == endpoints.startY) {
+					ClearLineBit(westLine, endpoints.startX);
+				}
+				if (endpoints.bExitOnRightEdge && line == endpoints.exitY) {
+					ClearLineBit(westLine, width);
+				}
+			}
+			else
+			{
+				std::fill(westLine.begin(), westLine.end(), ~uint64_t(0));
+				if (!endpoints.bExitOnRightEdge) {
+					ClearLineBit(southLine, endpoints.exitX);
+				}
+			}
+
+			if (!lineFunc(line, southLine.data(), westLine.data())) {
+				return false;
+			}
+			if (row) {
+				CopyEllerRowBits(row->northWalls, width, southLine);
+			}
+		}
+		return true;
+	}
+
+	/*===================
+	StreamEllerMazeFile
+
+	Lines are packed into one section buffer, which is written out whenever it fills. The wall hash
+	runs over the whole south plane before the west plane, so rather than keep the west plane the
+	rows are carved a second time from the same seed to hash it.
+	===================*/
+	bool StreamEllerMazeFile(int32_t width, int32_t height, uint64_t seed, const FMazeFileWriteFunc& write, FMazeFileHeader& outHeader,
+		int32_t sectionRows, const FMazeCancelFlag* cancel)
+	{
+		// The same draws as GenerateMazeFromSeed: the endpoints, then the generator's seed
+		FMazeRandom random(seed);
+		const FMazeEndpoints endpoints = ChooseEndpoints(width, height, random);
+		const uint64_t ellerSeed = random.Next();
+
+		FMazeFileHeader header = MakeMazeFileHeader(width, height, seed, EMazeGenAlgorithm::Eller, endpoints, sectionRows);
+		const int32_t wordsPerRow = GetMazeFileWordsPerRow(header);
+		const size_t rowBytes = size_t(wordsPerRow) * sizeof(uint64_t);
+		const int32_t rowCount = height + 1;
+
+		std::vector<uint64_t> section(size_t(header.sectionRows) * 2 * wordsPerRow);
+		size_t offset = sizeof(FMazeFileHeader);
+		int32_t firstRow = 0;
+		uint64_t hash = MazeWallHashBasis;
+		const bool bWritten = ForEachEllerPlaneLine(width, height, ellerSeed, endpoints, wordsPerRow, cancel,
+			[&](int32_t line, const uint64_t* southLine, const uint64_t* westLine)
+			{
+				hash = HashMazeWallWords(hash, southLine, size_t(wordsPerRow));
+
+				// A section holds its south lines, then the same west lines
+				const int32_t rows = std::min(header.sectionRows, rowCount - firstRow);
+				std::memcpy(section.data() + size_t(line - firstRow) * wordsPerRow, southLine, rowBytes);
+				std::memcpy(section.data() + size_t(rows + line - firstRow) * wordsPerRow, westLine, rowBytes);
+				if (line - firstRow + 1 < rows) {
+					return true;
+				}
+
+				const size_t sectionBytes = 2 * size_t(rows) * rowBytes;
+				if (!write(offset, reinterpret_cast<const uint8_t*>(section.data()), sectionBytes)) {
+					return false;
+				}
+				offset += sectionBytes;
+				firstRow += rows;
+				return true;
+			});
+		if (!bWritten) {
+			return false;
+		}
+
+		const bool bHashed = ForEachEllerPlaneLine(width, height, ellerSeed, endpoints, wordsPerRow, cancel,
+			[&](int32_t, const uint64_t*, const uint64_t* westLine)
+			{
+				hash = HashMazeWallWords(hash, westLine, size_t(wordsPerRow));
+				return true;
+			});
+		if (!bHashed) {
+			return false;
+		}
+
+		header.wallHash = hash;
+		outHeader = header;
+		return write(0, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+	}
+}
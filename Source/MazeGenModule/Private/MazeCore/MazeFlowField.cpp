@@ -0,0 +1,108 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeFlowField
+// Purpose: One direction byte per cell pointing one step along the shortest path to the nearest goal.
+// License: MIT
+
+#include "MazeCore/MazeFlowField.h"
+
+#include <algorithm>
+
+namespace MazeCore
+{
+	void FMazeFlowField::Init(const FMazeGrid& grid)
+	{
+		const size_t cellCount = size_t(grid.GetCellCount());
+		m_grid = &grid;
+		m_goals.clear();
+		m_directions.assign(cellCount, uint8_t(EMazeFlowDirection::Unreachable));
+		m_distances.assign(cellCount, Unreached);
+		m_queue.resize(cellCount);
+	}
+
+	size_t FMazeFlowField::GetAllocatedSize() const
+	{
+		return m_directions.capacity() + (m_goals.capacity() + m_distances.capacity() + m_queue.capacity()) * sizeof(int32_t);
+	}
+
+	/*===================
+	FMazeFlowField::Propagate
+
+	A cell is only re-queued when its distance improves, so adding a goal touches just the region
+	that is now closer to it. All edges cost one step, so the queue stays in distance order and
+	every cell settles the first time it is improved.
+	===================*/
+	void FMazeFlowField::Propagate(size_t tail)
+	{
+		const int32_t width = m_grid->GetWidth();
+		size_t head = 0;
+		while (head < tail)
+		{
+			const int32_t cell = m_queue[head++];
+			const int32_t distance = m_distances[cell] + 1;
+
+			int32_t neighbors[4];
+			const int32_t count = m_grid->GetOpenNeighbors(cell % width, cell / width, neighbors);
+			for (int32_t i = 0; i < count; i++)
+			{
+				const int32_t next = neighbors[i];
+				if (distance >= m_distances[next]) {
+					continue;
+				}
+				m_distances[next] = distance;
+
+				// The step from next back towards cell
+				const int32_t step = cell - next;
+				m_directions[next] = uint8_t(step == -1 ? EMazeFlowDirection::West
+					: step == 1 ? EMazeFlowDirection::East
+					: step < 0 ? EMazeFlowDirection::South
+					: EMazeFlowDirection::North);
+				m_queue[tail++] = next;
+			}
+		}
+	}
+
+	void FMazeFlowField::AddGoal(int32_t x, int32_t y)
+	{
+		const int32_t cell = m_grid->GetCellIndex(x, y);
+		if (std::find(m_goals.begin(), m_goals.end(), cell) != m_goals.end()) {
+			return;
+		}
+		m_goals.push_back(cell);
+
+		m_distances[cell] = 0;
+		m_directions[cell] = uint8_t(EMazeFlowDirection::AtGoal);
+		m_queue[0] = cell;
+		Propagate(1);
+	}
+
+	void FMazeFlowField::RemoveGoal(int32_t x, int32_t y)
+	{
+		const int32_t cell = m_grid->GetCellIndex(x, y);
+		const auto goal = std::find(m_goals.begin(), m_goals.end(), cell);
+		if (goal != m_goals.end()) {
+			m_goals.erase(goal);
+			Rebuild();
+		}
+	}
+
+	void FMazeFlowField::ClearGoals()
+	{
+		m_goals.clear();
+		Rebuild();
+	}
+
+	void FMazeFlowField::Rebuild()
+	{
+		std::fill(m_directions.begin(), m_directions.end(), uint8_t(EMazeFlowDirection::Unreachable));
+		std::fill(m_distances.begin(), m_distances.end(), Unreached);
+
+		// Every goal is a source of the same search
+		size_t tail = 0;
+		for (const int32_t goal : m_goals) {
+			m_distances[goal] = 0;
+			m_directions[goal] = uint8_t(EMazeFlowDirection::AtGoal);
+			m_queue[tail++] = goal;
+		}
+		Propagate(tail);
+	}
+}
@@ -0,0 +1,498 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Maze generation algorithms that carve passages into an FMazeGrid.
+// License: MIT
+
+#include "MazeCore/MazeGenerators.h"
+#include "MazeCore/MazeDisjointSet.h"
+#include "MazeCore/MazeEller.h"
+#include "MazeCore/MazeParallel.h"
+
+namespace MazeCore
+{
+	/*===================
+	GenerateRecursiveBacktracker
+
+	Generates a maze using a recursive backtracking algorithm. It marks cells as visited,
+	identifies valid neighbors, shuffles them for randomness, and removes walls between
+	neighboring cells. The function recursively explores and backtracks until the maze is complete.
+	===================*/
+	void GenerateRecursiveBacktracker(FMazeGrid& grid, FMazeRandom& random, int32_t x, int32_t y, const FMazeCancelFlag* cancel)
+	{
+		if (cancel && cancel->load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		// Step 1: Mark the current cell as visited
+		grid.SetVisited(x, y);
+
+		// Step 2: Identify valid neighbors (left, right, down, up)
+		int32_t neighbors[4][2];
+		int32_t count = 0;
+		if (x > 0 && !grid.IsVisited(x - 1, y)) {
+			neighbors[count][0] = x - 1;
+			neighbors[count++][1] = y;
+		}
+		if (x < grid.GetWidth() - 1 && !grid.IsVisited(x + 1, y)) {
+			neighbors[count][0] = x + 1;
+			neighbors[count++][1] = y;
+		}
+		if (y > 0 && !grid.IsVisited(x, y - 1)) {
+			neighbors[count][0] = x;
+			neighbors[count++][1] = y - 1;
+		}
+		if (y < grid.GetHeight() - 1 && !grid.IsVisited(x, y + 1)) {
+			neighbors[count][0] = x;
+			neighbors[count++][1] = y + 1;
+		}
+
+		// Step 3: Shuffle the neighbors to ensure random path generation
+		for (int32_t i = count - 1; i > 0; i--) {
+			const int32_t j = random.RandRange(0, i);
+			for (int32_t k = 0; k < 2; k++) {
+				const int32_t temp = neighbors[i][k];
+				neighbors[i][k] = neighbors[j][k];
+				neighbors[j][k] = temp;
+			}
+		}
+
+		// Step 4: Visit each neighbor, recursing into the ones still unvisited
+		for (int32_t i = 0; i < count; i++) {
+			const int32_t nx = neighbors[i][0];
+			const int32_t ny = neighbors[i][1];
+			if (!grid.IsVisited(nx, ny)) {
+				grid.RemoveWallBetween(x, y, nx, ny);
+				GenerateRecursiveBacktracker(grid, random, nx, ny, cancel);
+			}
+		}
+
+		// Step 5: Backtrack when no unvisited neighbors remain (the function returns)
+	}
+
+	/*===================
+	GenerateIterativeBacktracker
+
+	Generates the same kind of maze as the recursive version, but replaces the call stack with an
+	explicit stack of packed row-major cell indices. The stack is sized once for the worst case,
+	and neighbours are gathered into a fixed local buffer, so the loop does no heap allocation per
+	step and the depth of the maze no longer depends on the size of the thread's stack.
+	===================*/
+	void GenerateIterativeBacktracker(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel)
+	{
+		GenerateIterativeBacktrackerInRect(grid, random, 0, 0, grid.GetWidth(), grid.GetHeight(), startX, startY, cancel);
+	}
+
+	/*===================
+	GenerateIterativeBacktrackerInRect
+
+	The iterative backtracker restricted to a rectangle of the grid. Stack entries are packed
+	indices relative to the rectangle, so over the whole grid they are the usual cell indices.
+	===================*/
+	void GenerateIterativeBacktrackerInRect(FMazeGrid& grid, FMazeRandom& random, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY,
+		int32_t startX, int32_t startY, const FMazeCancelFlag* cancel)
+	{
+		const int32_t width = maxX - minX;
+		const int32_t height = maxY - minY;
+
+		// The worst case holds every cell at once (a single long corridor), but the stack only grows
+		// to the depth the maze reaches, so no memory is touched for the rest of it
+		std::vector<int32_t> stack;
+		stack.reserve(size_t(width + height) * 2);
+
+		grid.SetVisited(startX, startY);
+		stack.push_back((startY - minY) * width + (startX - minX));
+
+		uint32_t steps = 0;
+		while (!stack.empty())
+		{
+			// Poll for cancellation every few thousand steps
+			if ((++steps & 4095) == 0 && cancel && cancel->load(std::memory_order_relaxed)) {
+				return;
+			}
+
+			const int32_t current = stack.back();
+			const int32_t localX = current % width;
+			const int32_t localY = current / width;
+			const int32_t x = minX + localX;
+			const int32_t y = minY + localY;
+
+			// Gather unvisited neighbours (left, right, down, up)
+			int32_t neighbors[4];
+			int32_t count = 0;
+			if (localX > 0 && !grid.IsVisited(x - 1, y)) {
+				neighbors[count++] = current - 1;
+			}
+			if (localX < width - 1 && !grid.IsVisited(x + 1, y)) {
+				neighbors[count++] = current + 1;
+			}
+			if (localY > 0 && !grid.IsVisited(x, y - 1)) {
+				neighbors[count++] = current - width;
+			}
+			if (localY < height - 1 && !grid.IsVisited(x, y + 1)) {
+				neighbors[count++] = current + width;
+			}
+
+			// Backtrack when no unvisited neighbours remain
+			if (count == 0) {
+				stack.pop_back();
+				continue;
+			}
+
+			const int32_t next = neighbors[random.RandRange(0, count - 1)];
+			const int32_t nx = minX + next % width;
+			const int32_t ny = minY + next / width;
+
+			grid.RemoveWallBetween(x, y, nx, ny);
+			grid.SetVisited(nx, ny);
+			stack.push_back(next);
+		}
+	}
+
+	/*===================
+	GenerateWilson
+
+	Generates a uniform spanning tree with Wilson's algorithm. The start cell seeds the tree. From
+	each cell not yet in the tree a random walk runs until it reaches the tree, recording the
+	direction it last left every cell by. Overwriting that direction when the walk revisits a cell
+	erases the loop implicitly, so following the directions from the walk's first cell retraces the
+	loop-erased path, which is carved and added to the tree.
+	Directions live in one byte per cell, allocated once, and the walk tracks x and y itself, so no
+	step allocates or divides. A step draws two random bits and rejects moves off the grid.
+	The same random stream always produces the same maze.
+	===================*/
+	void GenerateWilson(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel)
+	{
+		const int32_t width = grid.GetWidth();
+		const int32_t height = grid.GetHeight();
+
+		// Low two bits: 0 = west, 1 = east, 2 = south, 3 = north. High bit: cell is in the tree.
+		// Keeping the tree flag next to the direction means a walk step touches a single byte.
+		const uint8_t inTree = 0x80;
+		const int32_t stepIndex[4] = { -1, 1, -width, width };
+		std::vector<uint8_t> cells(size_t(grid.GetCellCount()), 0);
+
+		grid.SetVisited(startX, startY);
+		cells[grid.GetCellIndex(startX, startY)] = inTree;
+
+		uint32_t steps = 0;
+		for (int32_t walkY = 0; walkY < height; walkY++) {
+			for (int32_t walkX = 0; walkX < width; walkX++)
+			{
+				const int32_t walkStart = grid.GetCellIndex(walkX, walkY);
+				if (cells[walkStart] & inTree) {
+					continue;
+				}
+
+				// Random walk until it hits the tree
+				int32_t x = walkX;
+				int32_t y = walkY;
+				int32_t cell = walkStart;
+				while (!(cells[cell] & inTree))
+				{
+					if ((++steps & 4095) == 0 && cancel && cancel->load(std::memory_order_relaxed)) {
+						return;
+					}
+
+					uint32_t direction;
+					do {
+						direction = random.NextBits(2);
+					} while ((direction == 0 && x == 0) || (direction == 1 && x == width - 1) ||
+						(direction == 2 && y == 0) || (direction == 3 && y == height - 1));
+
+					cells[cell] = uint8_t(direction);
+					cell += stepIndex[direction];
+					x += (direction == 1) - (direction == 0);
+					y += (direction == 3) - (direction == 2);
+				}
+
+				// Retrace the loop-erased path, carving it into the tree
+				x = walkX;
+				y = walkY;
+				cell = walkStart;
+				while (!(cells[cell] & inTree))
+				{
+					const uint8_t direction = cells[cell];
+					const int32_t nx = x + (direction == 1) - (direction == 0);
+					const int32_t ny = y + (direction == 3) - (direction == 2);
+					cells[cell] |= inTree;
+					grid.SetVisited(x, y);
+					grid.RemoveWallBetween(x, y, nx, ny);
+					cell += stepIndex[direction];
+					x = nx;
+					y = ny;
+				}
+			}
+		}
+	}
+
+	/*===================
+	GenerateKruskal
+
+	Every wall between two cells gets a packed id: cell * 2 for its east wall and cell * 2 + 1 for
+	its north wall. The ids are shuffled once and walked in order; a wall is removed when the cells
+	on either side are in different sets of a flat union-find, which then merges them. The walk
+	stops as soon as cellCount - 1 walls are gone, as the maze is complete at that point.
+	===================*/
+	void GenerateKruskal(FMazeGrid& grid, FMazeRandom& random, const FMazeCancelFlag* cancel)
+	{
+		const int32_t width = grid.GetWidth();
+		const int32_t height = grid.GetHeight();
+		const int32_t cellCount = grid.GetCellCount();
+
+		std::vector<uint32_t> walls;
+		walls.reserve(size_t(width - 1) * height + size_t(width) * (height - 1));
+		for (int32_t y = 0; y < height; y++) {
+			for (int32_t x = 0; x < width; x++)
+			{
+				const uint32_t cell = uint32_t(grid.GetCellIndex(x, y));
+				if (x < width - 1) {
+					walls.push_back(cell * 2);
+				}
+				if (y < height - 1) {
+					walls.push_back(cell * 2 + 1);
+				}
+			}
+		}
+
+		// Fisher-Yates shuffle
+		for (size_t i = walls.size(); i > 1; i--) {
+			const size_t j = random.NextBelow(uint32_t(i));
+			const uint32_t temp = walls[i - 1];
+			walls[i - 1] = walls[j];
+			walls[j] = temp;
+		}
+
+		FMazeDisjointSet sets;
+		sets.Init(cellCount);
+
+		int32_t removed = 0;
+		for (size_t i = 0; i < walls.size() && removed < cellCount - 1; i++)
+		{
+			if ((i & 4095) == 0 && cancel && cancel->load(std::memory_order_relaxed)) {
+				return;
+			}
+
+			const int32_t cell = int32_t(walls[i] >> 1);
+			const bool bNorth = (walls[i] & 1) != 0;
+			const int32_t neighbor = bNorth ? cell + width : cell + 1;
+			if (sets.Union(cell, neighbor))
+			{
+				const int32_t x = cell % width;
+				const int32_t y = cell / width;
+				if (bNorth) {
+					grid.SetNorthWall(x, y, false);
+				}
+				else {
+					grid.SetEastWall(x, y, false);
+				}
+				removed++;
+			}
+		}
+
+		for (int32_t y = 0; y < height; y++) {
+			for (int32_t x = 0; x < width; x++) {
+				grid.SetVisited(x, y);
+			}
+		}
+	}
+
+	/*===================
+	GeneratePrim
+
+	The frontier (unvisited cells next to the maze) is a flat array of packed indices plus one bit
+	per cell marking membership, so adding is a push, taking a random cell is a swap with the last
+	element, and no cell is added twice. A taken cell joins the maze through a random visited neighbour.
+	===================*/
+	void GeneratePrim(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel)
+	{
+		const int32_t width = grid.GetWidth();
+		const int32_t height = grid.GetHeight();
+
+		std::vector<int32_t> frontier;
+		frontier.reserve(size_t(width + height) * 2);
+		std::vector<uint64_t> inFrontier((size_t(grid.GetCellCount()) + 63) / 64, 0);
+
+		auto addToFrontier = [&grid, &frontier, &inFrontier](int32_t x, int32_t y)
+		{
+			const int32_t cell = grid.GetCellIndex(x, y);
+			const uint64_t mask = uint64_t(1) << (cell & 63);
+			if (!grid.IsVisited(x, y) && !(inFrontier[cell >> 6] & mask)) {
+				inFrontier[cell >> 6] |= mask;
+				frontier.push_back(cell);
+			}
+		};
+		auto addNeighbors = [width, height, &addToFrontier](int32_t x, int32_t y)
+		{
+			if (x > 0) {
+				addToFrontier(x - 1, y);
+			}
+			if (x < width - 1) {
+				addToFrontier(x + 1, y);
+			}
+			if (y > 0) {
+				addToFrontier(x, y - 1);
+			}
+			if (y < height - 1) {
+				addToFrontier(x, y + 1);
+			}
+		};
+
+		grid.SetVisited(startX, startY);
+		addNeighbors(startX, startY);
+
+		uint32_t steps = 0;
+		while (!frontier.empty())
+		{
+			if ((++steps & 4095) == 0 && cancel && cancel->load(std::memory_order_relaxed)) {
+				return;
+			}
+
+			// Take a random frontier cell (swap-remove)
+			const size_t pick = random.NextBelow(uint32_t(frontier.size()));
+			const int32_t cell = frontier[pick];
+			frontier[pick] = frontier.back();
+			frontier.pop_back();
+
+			const int32_t x = cell % width;
+			const int32_t y = cell / width;
+
+			// Connect it to a random neighbour that is already part of the maze
+			int32_t neighbors[4][2];
+			int32_t count = 0;
+			if (x > 0 && grid.IsVisited(x - 1, y)) {
+				neighbors[count][0] = x - 1;
+				neighbors[count++][1] = y;
+			}
+			if (x < width - 1 && grid.IsVisited(x + 1, y)) {
+				neighbors[count][0] = x + 1;
+				neighbors[count++][1] = y;
+			}
+			if (y > 0 && grid.IsVisited(x, y - 1)) {
+				neighbors[count][0] = x;
+				neighbors[count++][1] = y - 1;
+			}
+			if (y < height - 1 && grid.IsVisited(x, y + 1)) {
+				neighbors[count][0] = x;
+				neighbors[count++][1] = y + 1;
+			}
+			const int32_t chosen = int32_t(random.NextBelow(uint32_t(count)));
+			grid.RemoveWallBetween(x, y, neighbors[chosen][0], neighbors[chosen][1]);
+
+			grid.SetVisited(x, y);
+			addNeighbors(x, y);
+		}
+	}
+
+	const char* GetAlgorithmName(EMazeGenAlgorithm algorithm)
+	{
+		switch (algorithm)
+		{
+		case EMazeGenAlgorithm::RecursiveBacktracker: return "recursive-backtracker";
+		case EMazeGenAlgorithm::IterativeBacktracker: return "iterative-backtracker";
+		case EMazeGenAlgorithm::Wilson: return "wilson";
+		case EMazeGenAlgorithm::ParallelTiles: return "parallel-tiles";
+		case EMazeGenAlgorithm::Eller: return "eller";
+		case EMazeGenAlgorithm::Kruskal: return "kruskal";
+		case EMazeGenAlgorithm::Prim: return "prim";
+		}
+		return "unknown";
+	}
+
+	void GenerateMaze(FMazeGrid& grid, FMazeRandom& random, EMazeGenAlgorithm algorithm, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel,
+		int32_t threadCount)
+	{
+		switch (algorithm)
+		{
+		case EMazeGenAlgorithm::RecursiveBacktracker:
+			GenerateRecursiveBacktracker(grid, random, startX, startY, cancel);
+			break;
+		case EMazeGenAlgorithm::Wilson:
+			GenerateWilson(grid, random, startX, startY, cancel);
+			break;
+		case EMazeGenAlgorithm::ParallelTiles:
+			// A spanning tree has no start cell; the seed for the tiles comes from the stream
+			GenerateTiledMaze(grid, random.Next(), DefaultMazeTileSize, threadCount, cancel);
+			break;
+		case EMazeGenAlgorithm::Eller:
+			GenerateEllerMaze(grid.GetWidth(), grid.GetHeight(), random.Next(),
+				[&grid](const FMazeRowWalls& row) { ApplyMazeRow(grid, row); }, cancel);
+			break;
+		case EMazeGenAlgorithm::Kruskal:
+			GenerateKruskal(grid, random, cancel);
+			break;
+		case EMazeGenAlgorithm::Prim:
+			GeneratePrim(grid, random, startX, startY, cancel);
+			break;
+		case EMazeGenAlgorithm::IterativeBacktracker:
+		default:
+			GenerateIterativeBacktracker(grid, random, startX, startY, cancel);
+			break;
+		}
+	}
+
+	FMazeEndpoints ChooseEndpoints(const FMazeGrid& grid, FMazeRandom& random)
+	{
+		return ChooseEndpoints(grid.GetWidth(), grid.GetHeight(), random);
+	}
+
+	FMazeEndpoints ChooseEndpoints(int32_t width, int32_t height, FMazeRandom& random)
+	{
+		FMazeEndpoints endpoints;
+
+		// 50/50 chance for the exit to be on the right or top edge
+		endpoints.bExitOnRightEdge = random.RandBool();
+		if (endpoints.bExitOnRightEdge) {
+			endpoints.exitX = width - 1;
+			endpoints.exitY = random.RandRange(0, height - 1);
+		}
+		else {
+			endpoints.exitX = random.RandRange(0, width - 1);
+			endpoints.exitY = height - 1;
+		}
+		return endpoints;
+	}
+
+	void OpenEndpoints(FMazeGrid& grid, const FMazeEndpoints& endpoints)
+	{
+		// Entrance opening on the left side
+		grid.SetWestWall(endpoints.startX, endpoints.startY, false);
+
+		// Exit opening on the right or top side
+		if (endpoints.bExitOnRightEdge) {
+			grid.SetEastWall(endpoints.exitX, endpoints.exitY, false);
+		}
+		else {
+			grid.SetNorthWall(endpoints.exitX, endpoints.exitY, false);
+		}
+	}
+
+	FMazeEndpoints GenerateMazeFromSeed(FMazeGrid& grid, int32_t width, int32_t height, EMazeGenAlgorithm algorithm, uint64_t seed,
+		const FMazeCancelFlag* cancel, int32_t threadCount)
+	{
+		FMazeRandom random(seed);
+		grid.Init(width, height);
+		const FMazeEndpoints endpoints = ChooseEndpoints(grid, random);
+		GenerateMaze(grid, random, algorithm, endpoints.startX, endpoints.startY, cancel, threadCount);
+		OpenEndpoints(grid, endpoints);
+		return endpoints;
+	}
+
+	/*===================
+	GenerateTurnMaze
+
+	Each cell takes one random bit, so the rotation flags are filled a whole 64-bit word at a time.
+	===================*/
+	void GenerateTurnMaze(FMazeTurnGrid& turnGrid, FMazeRandom& random)
+	{
+		uint64_t* words = turnGrid.GetWords();
+		const size_t wordCount = turnGrid.GetWordCount();
+		for (size_t i = 0; i < wordCount; i++) {
+			words[i] = random.Next();
+		}
+
+		// Keep the unused bits past the last cell clear
+		const size_t usedBits = (size_t(turnGrid.GetWidth()) * turnGrid.GetHeight()) & 63;
+		if (wordCount > 0 && usedBits != 0) {
+			words[wordCount - 1] &= (uint64_t(1) << usedBits) - 1;
+		}
+	}
+}
@@ -0,0 +1,108 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeGrid, FMazeTurnGrid
+// Purpose: Flat, row-major maze grids that pack every cell into a few bits.
+// License: MIT
+
+#include "MazeCore/MazeGrid.h"
+
+#include <initializer_list>
+
+namespace MazeCore
+{
+	/*===================
+	FMazeGrid::Init
+
+	Allocates the wall and visited bitplanes as single contiguous blocks.
+	Every wall starts closed (bits set) and every cell starts unvisited (bits clear).
+	===================*/
+	void FMazeGrid::Init(int32_t width, int32_t height)
+	{
+		m_width = width;
+		m_height = height;
+		m_wordsPerRow = (width + 1 + 63) / 64;
+
+		const size_t wallWords = size_t(m_wordsPerRow) * (height + 1);
+		m_southWalls.assign(wallWords, ~uint64_t(0));
+		m_westWalls.assign(wallWords, ~uint64_t(0));
+		m_visited.assign(size_t(m_wordsPerRow) * height, 0);
+	}
+
+	size_t FMazeGrid::GetAllocatedSize() const
+	{
+		return (m_southWalls.capacity() + m_westWalls.capacity() + m_visited.capacity()) * sizeof(uint64_t);
+	}
+
+	/*===================
+	HashMazeWallWords
+
+	FNV-1a over the values of the wall words (not their bytes), so the result does not depend
+	on the endianness of the machine.
+	===================*/
+	uint64_t HashMazeWallWords(uint64_t hash, const uint64_t* words, size_t count)
+	{
+		for (size_t i = 0; i < count; i++) {
+			for (int32_t shift = 0; shift < 64; shift += 8) {
+				hash = (hash ^ ((words[i] >> shift) & 0xFF)) * 0x100000001B3ull;
+			}
+		}
+		return hash;
+	}
+
+	uint64_t FMazeGrid::ComputeWallHash() const
+	{
+		uint64_t hash = MazeWallHashBasis;
+		for (const std::vector<uint64_t>* plane : { &m_southWalls, &m_westWalls }) {
+			hash = HashMazeWallWords(hash, plane->data(), plane->size());
+		}
+		return hash;
+	}
+
+	// Set bits of a word, a few bits at a time instead of one by one
+	static int32_t CountGridWordBits(uint64_t word)
+	{
+		word = word - ((word >> 1) & 0x5555555555555555ull);
+		word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+		word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		return int32_t((word * 0x0101010101010101ull) >> 56);
+	}
+
+	/*===================
+	FMazeGrid::CountWalls
+
+	Counts the bits of both planes a word at a time. Only the first width + 1 bits of a row are
+	edges (width for horizontal lines), and only height rows of the vertical plane, so the bits
+	past them are masked off.
+	===================*/
+	int64_t FMazeGrid::CountWalls() const
+	{
+		auto countRow = [this](const std::vector<uint64_t>& plane, int32_t row, int32_t bitCount)
+		{
+			const uint64_t* words = &plane[size_t(row) * m_wordsPerRow];
+			int64_t count = 0;
+			int32_t word = 0;
+			for (; (word + 1) * 64 <= bitCount; word++) {
+				count += CountGridWordBits(words[word]);
+			}
+			if (word * 64 < bitCount) {
+				count += CountGridWordBits(words[word] & ((uint64_t(1) << (bitCount - word * 64)) - 1));
+			}
+			return count;
+		};
+
+		int64_t walls = 0;
+		for (int32_t row = 0; row <= m_height; row++) {
+			walls += countRow(m_southWalls, row, m_width);
+		}
+		for (int32_t row = 0; row < m_height; row++) {
+			walls += countRow(m_westWalls, row, m_width + 1);
+		}
+		return walls;
+	}
+
+	void FMazeTurnGrid::Init(int32_t width, int32_t height)
+	{
+		m_width = width;
+		m_height = height;
+		m_rotated.assign((size_t(width) * height + 63) / 64, 0);
+	}
+}
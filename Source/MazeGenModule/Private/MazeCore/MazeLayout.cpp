@@ -0,0 +1,138 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Converts a maze grid into floor and wall instance placements.
+// License: MIT
+
+#include "MazeCore/MazeLayout.h"
+
+namespace MazeCore
+{
+	void FMazeLayout::Reset()
+	{
+		floors.clear();
+		horizontalWalls.clear();
+		verticalWalls.clear();
+	}
+
+	/*===================
+	BuildFloors
+
+	A single floor instance stretched over the whole grid, or one floor instance per cell.
+	Like merged walls, the slab is scaled from the pivot a single cell's floor uses.
+	===================*/
+	static void BuildFloors(int32_t width, int32_t height, const FMazeLayoutSettings& settings, FMazeLayout& layout)
+	{
+		if (settings.floorLayout == EMazeFloorLayout::SingleSlab) {
+			layout.floors.push_back({ 0.0f, 0.0f, 0.0f, width * settings.meshScaleX, height * settings.meshScaleY, 0.1f * settings.meshScaleZ });
+			return;
+		}
+
+		const float scale = settings.positionScaling;
+		layout.floors.reserve(size_t(width) * size_t(height));
+		for (int32_t y = 0; y < height; y++) {
+			for (int32_t x = 0; x < width; x++) {
+				layout.floors.push_back({ x * scale, y * scale, 0.0f, settings.meshScaleX, settings.meshScaleY, 0.1f * settings.meshScaleZ });
+			}
+		}
+	}
+
+	FMazeInstance MakeWallInstance(bool bHorizontal, int32_t line, int32_t start, int32_t length, const FMazeLayoutSettings& settings)
+	{
+		const float scale = settings.positionScaling;
+		if (bHorizontal) {
+			return { start * scale + settings.zOffset, line * scale, 0.0f, length * settings.meshScaleX, 0.1f * settings.meshScaleY, settings.meshScaleZ };
+		}
+		return { line * scale, start * scale + settings.zOffset, 0.0f, 0.1f * settings.meshScaleX, length * settings.meshScaleY, settings.meshScaleZ };
+	}
+
+	/*===================
+	BuildWalls
+
+	Walks the grid lines rather than the cells, so each wall is seen exactly once.
+	Horizontal walls are scanned along their rows. Vertical walls are also scanned row by row,
+	keeping the start of the open run for every vertical line, so both passes read the wall
+	planes in memory order. With bMergeWalls a run of consecutive walls becomes a single
+	instance stretched along its length; otherwise every wall is its own instance.
+	===================*/
+	static void BuildWalls(const FMazeGrid& grid, const FMazeLayoutSettings& settings, bool bIncludeNorthEastBorders, FMazeLayout& layout)
+	{
+		const int32_t maxRun = settings.bMergeWalls ? INT32_MAX : 1;
+
+		const int32_t horizontalLines = bIncludeNorthEastBorders ? grid.GetHeight() + 1 : grid.GetHeight();
+		const int32_t verticalLines = bIncludeNorthEastBorders ? grid.GetWidth() + 1 : grid.GetWidth();
+
+		// Horizontal walls, one row line at a time
+		for (int32_t line = 0; line < horizontalLines; line++) {
+			int32_t x = 0;
+			while (x < grid.GetWidth()) {
+				if (!grid.HasHorizontalWall(x, line)) {
+					x++;
+					continue;
+				}
+				const int32_t start = x;
+				while (x < grid.GetWidth() && x - start < maxRun && grid.HasHorizontalWall(x, line)) {
+					x++;
+				}
+				layout.horizontalWalls.push_back(MakeWallInstance(true, line, start, x - start, settings));
+			}
+		}
+
+		// Vertical walls, tracking the open run of every column line while walking the rows
+		std::vector<int32_t> runStart(size_t(verticalLines), -1);
+		for (int32_t y = 0; y <= grid.GetHeight(); y++) {
+			for (int32_t line = 0; line < verticalLines; line++) {
+				const bool bWall = y < grid.GetHeight() && grid.HasVerticalWall(line, y);
+				int32_t& start = runStart[line];
+				if (start >= 0 && (!bWall || y - start >= maxRun)) {
+					layout.verticalWalls.push_back(MakeWallInstance(false, line, start, y - start, settings));
+					start = -1;
+				}
+				if (bWall && start < 0) {
+					start = y;
+				}
+			}
+		}
+	}
+
+	/*===================
+	BuildMazeLayout
+
+	Places a floor in every cell and a wall on every closed edge, including the outer border.
+	Horizontal walls run along X, vertical walls run along Y.
+	===================*/
+	void BuildMazeLayout(const FMazeGrid& grid, const FMazeLayoutSettings& settings, FMazeLayout& layout)
+	{
+		layout.Reset();
+		BuildFloors(grid.GetWidth(), grid.GetHeight(), settings, layout);
+		BuildWalls(grid, settings, true, layout);
+	}
+
+	void BuildChunkLayout(const FMazeGrid& grid, const FMazeLayoutSettings& settings, FMazeLayout& layout)
+	{
+		layout.Reset();
+		BuildFloors(grid.GetWidth(), grid.GetHeight(), settings, layout);
+		BuildWalls(grid, settings, false, layout);
+	}
+
+	/*===================
+	BuildTurnMazeLayout
+
+	Every cell gets a wall at its corner, in the shape of an unmerged horizontal wall, so the walls
+	the turn grid rotates swing about the same pivot as the rest.
+	===================*/
+	void BuildTurnMazeLayout(const FMazeTurnGrid& turnGrid, const FMazeLayoutSettings& settings, FMazeLayout& layout)
+	{
+		layout.Reset();
+		BuildFloors(turnGrid.GetWidth(), turnGrid.GetHeight(), settings, layout);
+
+		const float scale = settings.positionScaling;
+		const size_t cellCount = size_t(turnGrid.GetWidth()) * size_t(turnGrid.GetHeight());
+		layout.horizontalWalls.reserve(cellCount);
+		layout.verticalWalls.reserve(cellCount);
+		for (int32_t y = 0; y < turnGrid.GetHeight(); y++) {
+			for (int32_t x = 0; x < turnGrid.GetWidth(); x++) {
+				std::vector<FMazeInstance>& walls = turnGrid.IsRotated(x, y) ? layout.verticalWalls : layout.horizontalWalls;
+				walls.push_back({ x * scale, y * scale, 0.0f, settings.meshScaleX, 0.1f * settings.meshScaleY, settings.meshScaleZ });
+			}
+		}
+	}
+}
@@ -0,0 +1,126 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Multithreaded maze generation by tiles.
+// License: MIT
+
+#include "MazeCore/MazeParallel.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace MazeCore
+{
+	// Seed salt for the spanning tree that joins the tiles (tile seeds use the tile index)
+	static const uint64_t TileJoinSalt = 0x4A6F696E54696C65ull;
+
+	int32_t GetAlignedTileSize(int32_t tileSize)
+	{
+		return std::max(64, (tileSize + 63) & ~63);
+	}
+
+	void GetTileCounts(const FMazeGrid& grid, int32_t tileSize, int32_t& outTilesX, int32_t& outTilesY)
+	{
+		const int32_t alignedSize = GetAlignedTileSize(tileSize);
+		outTilesX = (grid.GetWidth() + alignedSize - 1) / alignedSize;
+		outTilesY = (grid.GetHeight() + alignedSize - 1) / alignedSize;
+	}
+
+	void GenerateMazeTile(FMazeGrid& grid, uint64_t seed, int32_t tileSize, int32_t tileIndex, const FMazeCancelFlag* cancel)
+	{
+		const int32_t alignedSize = GetAlignedTileSize(tileSize);
+		int32_t tilesX, tilesY;
+		GetTileCounts(grid, tileSize, tilesX, tilesY);
+
+		const int32_t minX = (tileIndex % tilesX) * alignedSize;
+		const int32_t minY = (tileIndex / tilesX) * alignedSize;
+		const int32_t maxX = std::min(minX + alignedSize, grid.GetWidth());
+		const int32_t maxY = std::min(minY + alignedSize, grid.GetHeight());
+
+		FMazeRandom random(MixSeed(seed, uint64_t(tileIndex)));
+		const int32_t startX = minX + int32_t(random.NextBelow(uint32_t(maxX - minX)));
+		const int32_t startY = minY + int32_t(random.NextBelow(uint32_t(maxY - minY)));
+		GenerateIterativeBacktrackerInRect(grid, random, minX, minY, maxX, maxY, startX, startY, cancel);
+	}
+
+	/*===================
+	JoinMazeTiles
+
+	Every tile is a spanning tree of its own cells, so opening exactly one wall per edge of a
+	spanning tree over the tiles yields a spanning tree of the whole grid. The tile tree comes from
+	Wilson's algorithm on a grid with one cell per tile, so the large-scale layout has no bias.
+	===================*/
+	void JoinMazeTiles(FMazeGrid& grid, uint64_t seed, int32_t tileSize)
+	{
+		const int32_t alignedSize = GetAlignedTileSize(tileSize);
+		int32_t tilesX, tilesY;
+		GetTileCounts(grid, tileSize, tilesX, tilesY);
+
+		FMazeRandom random(MixSeed(seed, TileJoinSalt));
+		FMazeGrid tileGrid;
+		tileGrid.Init(tilesX, tilesY);
+		GenerateWilson(tileGrid, random, 0, 0);
+
+		for (int32_t tileY = 0; tileY < tilesY; tileY++) {
+			for (int32_t tileX = 0; tileX < tilesX; tileX++)
+			{
+				const int32_t minX = tileX * alignedSize;
+				const int32_t minY = tileY * alignedSize;
+				const int32_t maxX = std::min(minX + alignedSize, grid.GetWidth());
+				const int32_t maxY = std::min(minY + alignedSize, grid.GetHeight());
+
+				// Opening at a random cell of the tile's right column
+				if (tileX < tilesX - 1 && !tileGrid.HasEastWall(tileX, tileY)) {
+					grid.SetEastWall(maxX - 1, minY + int32_t(random.NextBelow(uint32_t(maxY - minY))), false);
+				}
+
+				// Opening at a random cell of the tile's top row
+				if (tileY < tilesY - 1 && !tileGrid.HasNorthWall(tileX, tileY)) {
+					grid.SetNorthWall(minX + int32_t(random.NextBelow(uint32_t(maxX - minX))), maxY - 1, false);
+				}
+			}
+		}
+	}
+
+	/*===================
+	GenerateTiledMaze
+
+	Threads take the next tile from a shared counter until none are left, so a thread that gets
+	small or quick tiles simply carves more of them. The calling thread works as well.
+	===================*/
+	void GenerateTiledMaze(FMazeGrid& grid, uint64_t seed, int32_t tileSize, int32_t threadCount, const FMazeCancelFlag* cancel)
+	{
+		int32_t tilesX, tilesY;
+		GetTileCounts(grid, tileSize, tilesX, tilesY);
+		const int32_t tileCount = tilesX * tilesY;
+
+		if (threadCount <= 0) {
+			threadCount = std::max(1, int32_t(std::thread::hardware_concurrency()));
+		}
+		threadCount = std::min(threadCount, tileCount);
+
+		std::atomic<int32_t> nextTile(0);
+		auto carveTiles = [&grid, &nextTile, seed, tileSize, tileCount, cancel]()
+		{
+			for (int32_t tile = nextTile.fetch_add(1); tile < tileCount; tile = nextTile.fetch_add(1)) {
+				if (cancel && cancel->load(std::memory_order_relaxed)) {
+					return;
+				}
+				GenerateMazeTile(grid, seed, tileSize, tile, cancel);
+			}
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve(size_t(std::max(0, threadCount - 1)));
+		for (int32_t i = 1; i < threadCount; i++) {
+			workers.emplace_back(carveTiles);
+		}
+		carveTiles();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+
+		if (cancel && cancel->load(std::memory_order_relaxed)) {
+			return;
+		}
+		JoinMazeTiles(grid, seed, tileSize);
+	}
+}
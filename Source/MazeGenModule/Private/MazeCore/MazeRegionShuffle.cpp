@@ -0,0 +1,337 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeRegionShuffle
+// Purpose: Re-randomises a rectangle of a finished maze in bounded steps, keeping it perfect.
+// License: MIT
+
+#include "MazeCore/MazeRegionShuffle.h"
+
+#include <algorithm>
+
+namespace MazeCore
+{
+	/*===================
+	FMazeRegionShuffle::Start
+
+	Lists the walls on the border of the region that have a cell of the maze behind them. Walls
+	on the outer border of the maze (and so the entrance and exit) are never touched.
+	===================*/
+	bool FMazeRegionShuffle::Start(const FMazeGrid& grid, int32_t minX, int32_t minY, int32_t width, int32_t height, uint64_t seed)
+	{
+		const int32_t maxX = std::min(minX + width, grid.GetWidth());
+		const int32_t maxY = std::min(minY + height, grid.GetHeight());
+		m_minX = std::max(minX, 0);
+		m_minY = std::max(minY, 0);
+		m_width = maxX - m_minX;
+		m_height = maxY - m_minY;
+		if (m_width <= 0 || m_height <= 0)
+		{
+			m_step = EStep::Idle;
+			return false;
+		}
+		m_gridWidth = grid.GetWidth();
+		m_seed = seed;
+
+		m_borderWalls.clear();
+		for (int32_t x = m_minX; x < maxX; x++)
+		{
+			if (m_minY > 0) {
+				m_borderWalls.push_back({ { true, m_minY, x }, grid.GetCellIndex(x, m_minY - 1) });
+			}
+			if (maxY < grid.GetHeight()) {
+				m_borderWalls.push_back({ { true, maxY, x }, grid.GetCellIndex(x, maxY) });
+			}
+		}
+		for (int32_t y = m_minY; y < maxY; y++)
+		{
+			if (m_minX > 0) {
+				m_borderWalls.push_back({ { false, m_minX, y }, grid.GetCellIndex(m_minX - 1, y) });
+			}
+			if (maxX < grid.GetWidth()) {
+				m_borderWalls.push_back({ { false, maxX, y }, grid.GetCellIndex(maxX, y) });
+			}
+		}
+
+		m_gridHeight = grid.GetHeight();
+		m_pieces.Clear();
+		m_nextCell = 0;
+		m_stack.clear();
+		m_changedWalls.clear();
+		m_nextRow = -1;
+		m_random.Seed(m_seed);
+		m_step = EStep::Label;
+		return true;
+	}
+
+	void FMazeRegionShuffle::Reserve(const FMazeGrid& grid)
+	{
+		m_step = EStep::Idle;
+		m_pieces.Reserve(grid.GetCellCount());
+	}
+
+	/*===================
+	FMazeRegionShuffle::NoteWallEdit
+
+	A wall the row scan has read is in the pieces already, so opening it joins the two pieces it
+	separates. If their openings are picked, one of the two is closed again.
+	===================*/
+	void FMazeRegionShuffle::NoteWallEdit(const FMazeWallEdge& edge, bool bWall)
+	{
+		if (!IsRunning() || bWall) {
+			return;
+		}
+
+		// The cells on either side, skipping the outer border of the maze
+		const int32_t lineCount = edge.bHorizontal ? m_gridHeight : m_gridWidth;
+		if (edge.line <= 0 || edge.line >= lineCount) {
+			return;
+		}
+		const int32_t x = edge.bHorizontal ? edge.position : edge.line;
+		const int32_t y = edge.bHorizontal ? edge.line : edge.position;
+		const int32_t previousX = edge.bHorizontal ? x : x - 1;
+		const int32_t previousY = edge.bHorizontal ? y - 1 : y;
+		if (IsInRegion(x, y) || IsInRegion(previousX, previousY)) {
+			return;
+		}
+
+		// The row scan reads the wall with the later cell, so it has not seen it yet
+		const int32_t cell = y * m_gridWidth + x;
+		if (m_step == EStep::Label && cell >= m_nextCell) {
+			return;
+		}
+		const int32_t previousCell = previousY * m_gridWidth + previousX;
+		if (!m_pieces.Union(cell, previousCell) || m_nextRow < 0) {
+			return;
+		}
+
+		const int32_t root = m_pieces.Find(cell);
+		bool bKept = false;
+		for (size_t i = 0; i < m_borderWalls.size(); i++)
+		{
+			if (m_bOpenings[i] != 0 && m_pieces.Find(m_borderWalls[i].outsideCell) == root)
+			{
+				m_bOpenings[i] = bKept ? 0 : 1;
+				bKept = true;
+			}
+		}
+	}
+
+	bool FMazeRegionShuffle::Advance(FMazeGrid& grid, int32_t workLimit)
+	{
+		int32_t work = 0;
+		while (work < workLimit && IsRunning())
+		{
+			switch (m_step)
+			{
+			case EStep::Label:
+				work += Label(grid, workLimit - work);
+				break;
+			case EStep::Carve:
+				work += Carve(workLimit - work);
+				break;
+			default:
+				work += Apply(grid, workLimit - work);
+				break;
+			}
+		}
+		return IsDone();
+	}
+
+	/*===================
+	FMazeRegionShuffle::Label
+
+	Joins every cell outside the region to its west and south neighbours through open walls.
+	Rows are read in memory order and most joins find a root within a step or two, so this visits
+	every cell of the maze once at close to the speed of reading the grid.
+	===================*/
+	int32_t FMazeRegionShuffle::Label(const FMazeGrid& grid, int32_t workLimit)
+	{
+		const int32_t first = m_nextCell;
+		const int32_t last = std::min(m_gridWidth * m_gridHeight, first + workLimit);
+		int32_t x = first % m_gridWidth;
+		int32_t y = first / m_gridWidth;
+		for (int32_t cell = first; cell < last; cell++)
+		{
+			m_pieces.Add();
+			if (!IsInRegion(x, y))
+			{
+				if (x > 0 && !grid.HasWestWall(x, y) && !IsInRegion(x - 1, y)) {
+					m_pieces.Union(cell, cell - 1);
+				}
+				if (y > 0 && !grid.HasSouthWall(x, y) && !IsInRegion(x, y - 1)) {
+					m_pieces.Union(cell, cell - m_gridWidth);
+				}
+			}
+			if (++x == m_gridWidth)
+			{
+				x = 0;
+				y++;
+			}
+		}
+		m_nextCell = last;
+
+		if (last == m_gridWidth * m_gridHeight)
+		{
+			m_region.Init(m_width, m_height);
+			const int32_t start = int32_t(m_random.NextBelow(uint32_t(m_width * m_height)));
+			m_region.SetVisited(start % m_width, start / m_width);
+			m_stack.push_back(start);
+			m_step = EStep::Carve;
+		}
+		return last - first;
+	}
+
+	/*===================
+	FMazeRegionShuffle::Carve
+
+	The iterative backtracker on the region's own grid, resumed where the last call stopped
+	===================*/
+	int32_t FMazeRegionShuffle::Carve(int32_t workLimit)
+	{
+		int32_t work = 0;
+		while (work < workLimit)
+		{
+			if (m_stack.empty())
+			{
+				m_step = EStep::Apply;
+				return work;
+			}
+			work++;
+
+			const int32_t current = m_stack.back();
+			const int32_t x = current % m_width;
+			const int32_t y = current / m_width;
+
+			// Gather unvisited neighbours (left, right, down, up)
+			int32_t neighbors[4];
+			int32_t count = 0;
+			if (x > 0 && !m_region.IsVisited(x - 1, y)) {
+				neighbors[count++] = current - 1;
+			}
+			if (x < m_width - 1 && !m_region.IsVisited(x + 1, y)) {
+				neighbors[count++] = current + 1;
+			}
+			if (y > 0 && !m_region.IsVisited(x, y - 1)) {
+				neighbors[count++] = current - m_width;
+			}
+			if (y < m_height - 1 && !m_region.IsVisited(x, y + 1)) {
+				neighbors[count++] = current + m_width;
+			}
+
+			if (count == 0)
+			{
+				m_stack.pop_back();
+				continue;
+			}
+
+			const int32_t next = neighbors[m_random.RandRange(0, count - 1)];
+			m_region.RemoveWallBetween(x, y, next % m_width, next / m_width);
+			m_region.SetVisited(next % m_width, next / m_width);
+			m_stack.push_back(next);
+		}
+		return work;
+	}
+
+	/*===================
+	FMazeRegionShuffle::Apply
+
+	Writes the new region into the grid a row at a time, then closes every border wall but the
+	openings. The new region is a tree and every piece hangs off it by one wall, so the maze is a
+	tree again once the last step is done.
+	===================*/
+	int32_t FMazeRegionShuffle::Apply(FMazeGrid& grid, int32_t workLimit)
+	{
+		int32_t work = 0;
+		if (m_nextRow < 0)
+		{
+			ChooseOpenings();
+			m_changedWalls.clear();
+			m_nextRow = 0;
+			work += int32_t(m_borderWalls.size());
+		}
+
+		for (; m_nextRow < m_height && work < workLimit; m_nextRow++)
+		{
+			const int32_t y = m_minY + m_nextRow;
+			if (m_nextRow > 0) {
+				for (int32_t x = m_minX; x < m_minX + m_width; x++) {
+					SetWall(grid, { true, y, x }, m_region.HasHorizontalWall(x - m_minX, m_nextRow));
+				}
+			}
+			for (int32_t line = m_minX + 1; line < m_minX + m_width; line++) {
+				SetWall(grid, { false, line, y }, m_region.HasVerticalWall(line - m_minX, m_nextRow));
+			}
+			work += m_width;
+		}
+
+		if (m_nextRow == m_height && work < workLimit)
+		{
+			for (size_t i = 0; i < m_borderWalls.size(); i++) {
+				SetWall(grid, m_borderWalls[i].edge, m_bOpenings[i] == 0);
+			}
+			work += int32_t(m_borderWalls.size());
+			m_step = EStep::Done;
+		}
+		return std::max(work, 1);
+	}
+
+	/*===================
+	FMazeRegionShuffle::ChooseOpenings
+
+	Every piece gets one opening, picked uniformly among its border walls
+	===================*/
+	void FMazeRegionShuffle::ChooseOpenings()
+	{
+		// Number the pieces by their roots
+		const int32_t borderWallCount = int32_t(m_borderWalls.size());
+		std::vector<int32_t> wallPieces(m_borderWalls.size());
+		for (int32_t i = 0; i < borderWallCount; i++) {
+			wallPieces[i] = m_pieces.Find(m_borderWalls[i].outsideCell);
+		}
+		std::vector<int32_t> roots(wallPieces);
+		std::sort(roots.begin(), roots.end());
+		roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+		for (int32_t& piece : wallPieces) {
+			piece = int32_t(std::lower_bound(roots.begin(), roots.end(), piece) - roots.begin());
+		}
+
+		std::vector<int32_t> openings(roots.size(), -1);
+		std::vector<int32_t> candidates(roots.size(), 0);
+		for (int32_t i = 0; i < borderWallCount; i++)
+		{
+			const int32_t piece = wallPieces[i];
+			if (m_random.NextBelow(uint32_t(++candidates[piece])) == 0) {
+				openings[piece] = i;
+			}
+		}
+
+		m_bOpenings.assign(m_borderWalls.size(), 0);
+		for (const int32_t opening : openings) {
+			m_bOpenings[opening] = 1;
+		}
+	}
+
+	void FMazeRegionShuffle::SetWall(FMazeGrid& grid, const FMazeWallEdge& edge, bool bWall)
+	{
+		if (edge.bHorizontal)
+		{
+			if (grid.HasHorizontalWall(edge.position, edge.line) == bWall) {
+				return;
+			}
+			grid.SetSouthWall(edge.position, edge.line, bWall);
+		}
+		else
+		{
+			if (grid.HasVerticalWall(edge.line, edge.position) == bWall) {
+				return;
+			}
+			grid.SetWestWall(edge.line, edge.position, bWall);
+		}
+		m_changedWalls.push_back(edge);
+	}
+
+	size_t FMazeRegionShuffle::GetAllocatedSize() const
+	{
+		return m_borderWalls.capacity() * sizeof(FBorderWall) + m_pieces.GetAllocatedSize() + m_stack.capacity() * sizeof(int32_t)
+			+ m_changedWalls.capacity() * sizeof(FMazeWallEdge) + m_region.GetAllocatedSize() + m_bOpenings.capacity();
+	}
+}
@@ -0,0 +1,215 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeSolver
+// Purpose: Queries over a generated maze grid (reachability, validation, distances and paths).
+// License: MIT
+
+#include "MazeCore/MazeSolver.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace MazeCore
+{
+	/*===================
+	CountReachableCells
+
+	Breadth-first flood fill from (x, y) using a flat queue of packed cell indices.
+	===================*/
+	int32_t CountReachableCells(const FMazeGrid& grid, int32_t x, int32_t y)
+	{
+		const int32_t width = grid.GetWidth();
+		std::vector<int32_t> queue(size_t(grid.GetCellCount()));
+		std::vector<uint8_t> seen(size_t(grid.GetCellCount()), 0);
+
+		size_t head = 0;
+		size_t tail = 0;
+		queue[tail++] = grid.GetCellIndex(x, y);
+		seen[queue[0]] = 1;
+
+		while (head < tail)
+		{
+			const int32_t cell = queue[head++];
+			const int32_t cx = cell % width;
+			const int32_t cy = cell / width;
+
+			int32_t neighbors[4];
+			int32_t count = 0;
+			if (cx > 0 && !grid.HasWestWall(cx, cy)) {
+				neighbors[count++] = cell - 1;
+			}
+			if (cx < width - 1 && !grid.HasEastWall(cx, cy)) {
+				neighbors[count++] = cell + 1;
+			}
+			if (cy > 0 && !grid.HasSouthWall(cx, cy)) {
+				neighbors[count++] = cell - width;
+			}
+			if (cy < grid.GetHeight() - 1 && !grid.HasNorthWall(cx, cy)) {
+				neighbors[count++] = cell + width;
+			}
+
+			for (int32_t i = 0; i < count; i++) {
+				if (!seen[neighbors[i]]) {
+					seen[neighbors[i]] = 1;
+					queue[tail++] = neighbors[i];
+				}
+			}
+		}
+		return int32_t(tail);
+	}
+
+	int64_t CountPassages(const FMazeGrid& grid)
+	{
+		int64_t passages = 0;
+		for (int32_t y = 0; y < grid.GetHeight(); y++) {
+			for (int32_t x = 0; x < grid.GetWidth(); x++) {
+				if (x > 0 && !grid.HasWestWall(x, y)) {
+					passages++;
+				}
+				if (y > 0 && !grid.HasSouthWall(x, y)) {
+					passages++;
+				}
+			}
+		}
+		return passages;
+	}
+
+	/*===================
+	IsPerfectMaze
+
+	A maze is perfect when it is a spanning tree of the grid: connected, with exactly
+	one fewer passage than cells.
+	===================*/
+	bool IsPerfectMaze(const FMazeGrid& grid)
+	{
+		if (grid.GetCellCount() == 0) {
+			return false;
+		}
+		return CountPassages(grid) == int64_t(grid.GetCellCount()) - 1
+			&& CountReachableCells(grid, 0, 0) == grid.GetCellCount();
+	}
+
+	void FMazeSolver::Init(const FMazeGrid& grid)
+	{
+		const size_t cellCount = size_t(grid.GetCellCount());
+		m_grid = &grid;
+
+		// Stamps start below the epoch, so nothing reads as reached before the first query
+		m_epoch = 1;
+		m_stamp.assign(cellCount, 0);
+		m_distance.resize(cellCount);
+		m_parent.resize(cellCount);
+		m_queue.resize(cellCount);
+		m_openHeap.clear();
+		m_openHeap.reserve(1024);
+	}
+
+	size_t FMazeSolver::GetAllocatedSize() const
+	{
+		return m_stamp.capacity() * sizeof(uint32_t) + (m_distance.capacity() + m_parent.capacity() + m_queue.capacity()) * sizeof(int32_t)
+			+ m_openHeap.capacity() * sizeof(uint64_t);
+	}
+
+	void FMazeSolver::BeginQuery()
+	{
+		// On wrap-around clear the stamps once so no stale entry can match the new epoch
+		if (++m_epoch == 0) {
+			std::fill(m_stamp.begin(), m_stamp.end(), 0);
+			m_epoch = 1;
+		}
+	}
+
+	void FMazeSolver::ComputeDistanceField(int32_t x, int32_t y)
+	{
+		BeginQuery();
+
+		const int32_t width = m_grid->GetWidth();
+		size_t head = 0;
+		size_t tail = 0;
+		const int32_t start = m_grid->GetCellIndex(x, y);
+		Visit(start, 0, -1);
+		m_queue[tail++] = start;
+
+		while (head < tail)
+		{
+			const int32_t cell = m_queue[head++];
+			int32_t neighbors[4];
+			const int32_t count = m_grid->GetOpenNeighbors(cell % width, cell / width, neighbors);
+			for (int32_t i = 0; i < count; i++) {
+				if (!IsCurrent(neighbors[i])) {
+					Visit(neighbors[i], m_distance[cell] + 1, cell);
+					m_queue[tail++] = neighbors[i];
+				}
+			}
+		}
+	}
+
+	int32_t FMazeSolver::GetPathToFieldStart(int32_t x, int32_t y, std::vector<int32_t>& outPath) const
+	{
+		outPath.clear();
+		const int32_t cell = m_grid->GetCellIndex(x, y);
+		if (!IsCurrent(cell)) {
+			return -1;
+		}
+		for (int32_t step = cell; step != -1; step = m_parent[step]) {
+			outPath.push_back(step);
+		}
+		return m_distance[cell];
+	}
+
+	/*===================
+	FMazeSolver::FindPath
+
+	Open list entries pack the estimated total cost above the cell index, so the heap orders them
+	with a single integer compare. The Manhattan heuristic never overestimates on a grid, so the
+	first time the goal is popped its distance is the shortest one.
+	===================*/
+	int32_t FMazeSolver::FindPath(int32_t startX, int32_t startY, int32_t goalX, int32_t goalY, std::vector<int32_t>& outPath)
+	{
+		BeginQuery();
+		outPath.clear();
+
+		const int32_t width = m_grid->GetWidth();
+		const int32_t start = m_grid->GetCellIndex(startX, startY);
+		const int32_t goal = m_grid->GetCellIndex(goalX, goalY);
+		auto estimate = [width, goalX, goalY](int32_t cell, int32_t distance)
+		{
+			const int32_t dx = cell % width - goalX;
+			const int32_t dy = cell / width - goalY;
+			return uint64_t(uint32_t(distance + (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy))) << 32 | uint32_t(cell);
+		};
+
+		m_openHeap.clear();
+		Visit(start, 0, -1);
+		m_openHeap.push_back(estimate(start, 0));
+
+		while (!m_openHeap.empty())
+		{
+			std::pop_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+			const int32_t cell = int32_t(uint32_t(m_openHeap.back()));
+			m_openHeap.pop_back();
+
+			if (cell == goal)
+			{
+				for (int32_t step = goal; step != -1; step = m_parent[step]) {
+					outPath.push_back(step);
+				}
+				std::reverse(outPath.begin(), outPath.end());
+				return m_distance[goal];
+			}
+
+			int32_t neighbors[4];
+			const int32_t count = m_grid->GetOpenNeighbors(cell % width, cell / width, neighbors);
+			const int32_t distance = m_distance[cell] + 1;
+			for (int32_t i = 0; i < count; i++)
+			{
+				const int32_t next = neighbors[i];
+				if (!IsCurrent(next) || distance < m_distance[next]) {
+					Visit(next, distance, cell);
+					m_openHeap.push_back(estimate(next, distance));
+					std::push_heap(m_openHeap.begin(), m_openHeap.end(), std::greater<uint64_t>());
+				}
+			}
+		}
+		return -1;
+	}
+}
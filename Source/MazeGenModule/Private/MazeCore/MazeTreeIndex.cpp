@@ -0,0 +1,190 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeTreeIndex
+// Purpose: Constant time distance and path membership queries between any two cells of a perfect maze.
+// License: MIT
+
+#include "MazeCore/MazeTreeIndex.h"
+#include "MazeCore/MazeSolver.h"
+
+#include <algorithm>
+
+namespace MazeCore
+{
+	/*===================
+	FloorLog2
+	===================*/
+	static int32_t FloorLog2(uint32_t value)
+	{
+		int32_t log = 0;
+		while (value >>= 1) {
+			log++;
+		}
+		return log;
+	}
+
+	/*===================
+	FMazeTreeIndex::Build
+
+	A depth-first walk from the first cell of every tree, taking each cell off the stack before its
+	children go on, numbers every subtree as one contiguous run of positions. Stack entries pack the
+	depth above the cell index. The walk cannot tell a tree from a graph with loops by itself (a cell
+	in a loop is pushed twice and numbered once), so afterwards the passages are counted: a forest
+	has exactly one passage fewer than cells in every tree.
+	===================*/
+	bool FMazeTreeIndex::Build(const FMazeGrid& grid)
+	{
+		const int32_t cellCount = grid.GetCellCount();
+		m_width = grid.GetWidth();
+		m_preorder.assign(size_t(cellCount), -1);
+		m_depths.resize(size_t(cellCount));
+		m_treeStarts.clear();
+
+		std::vector<uint64_t> stack;
+		int32_t position = 0;
+		for (int32_t root = 0; root < cellCount; root++)
+		{
+			if (m_preorder[root] >= 0) {
+				continue;
+			}
+			m_treeStarts.push_back(position);
+			stack.push_back(uint32_t(root));
+			while (!stack.empty())
+			{
+				const int32_t cell = int32_t(uint32_t(stack.back()));
+				const int32_t depth = int32_t(stack.back() >> 32);
+				stack.pop_back();
+				if (m_preorder[cell] >= 0) {
+					continue;
+				}
+				m_preorder[cell] = position;
+				m_depths[position++] = depth;
+
+				int32_t neighbors[4];
+				const int32_t count = grid.GetOpenNeighbors(cell % m_width, cell / m_width, neighbors);
+				for (int32_t i = 0; i < count; i++)
+				{
+					if (m_preorder[neighbors[i]] < 0) {
+						stack.push_back(uint64_t(uint32_t(depth + 1)) << 32 | uint32_t(neighbors[i]));
+					}
+				}
+			}
+		}
+
+		if (CountPassages(grid) != int64_t(cellCount) - int64_t(m_treeStarts.size()))
+		{
+			m_preorder.clear();
+			m_depths.clear();
+			m_blockMinima.clear();
+			m_treeStarts.clear();
+			m_blockCount = 0;
+			return false;
+		}
+
+		// Level 0 is the minimum of every block, level k combines two halves from level k - 1
+		m_blockCount = (cellCount + BlockSize - 1) >> BlockShift;
+		const int32_t levels = m_blockCount > 0 ? FloorLog2(uint32_t(m_blockCount)) + 1 : 0;
+		m_blockMinima.resize(size_t(m_blockCount) * levels);
+		for (int32_t block = 0; block < m_blockCount; block++)
+		{
+			const int32_t first = block << BlockShift;
+			const int32_t last = std::min(first + BlockSize, cellCount);
+			m_blockMinima[block] = *std::min_element(m_depths.begin() + first, m_depths.begin() + last);
+		}
+		for (int32_t level = 1; level < levels; level++)
+		{
+			const int32_t* previous = &m_blockMinima[size_t(level - 1) * m_blockCount];
+			int32_t* current = &m_blockMinima[size_t(level) * m_blockCount];
+			const int32_t half = 1 << (level - 1);
+			for (int32_t block = 0; block + (1 << level) <= m_blockCount; block++) {
+				current[block] = std::min(previous[block], previous[block + half]);
+			}
+		}
+		return true;
+	}
+
+	size_t FMazeTreeIndex::GetAllocatedSize() const
+	{
+		return (m_preorder.capacity() + m_depths.capacity() + m_blockMinima.capacity() + m_treeStarts.capacity()) * sizeof(int32_t);
+	}
+
+	int32_t FMazeTreeIndex::GetMinBlockDepth(int32_t first, int32_t last) const
+	{
+		const int32_t level = FloorLog2(uint32_t(last - first + 1));
+		const int32_t* minima = &m_blockMinima[size_t(level) * m_blockCount];
+		return std::min(minima[first], minima[last - (1 << level) + 1]);
+	}
+
+	/*===================
+	FMazeTreeIndex::GetMinDepth
+
+	Scans the partial blocks at both ends, at most 2 * BlockSize depths, and takes the whole blocks
+	in between from the sparse table with two overlapping lookups.
+	===================*/
+	int32_t FMazeTreeIndex::GetMinDepth(int32_t first, int32_t last) const
+	{
+		// A plain running minimum rather than std::min_element, so the compiler can vectorise it
+		auto scan = [this](int32_t from, int32_t to, int32_t minDepth)
+		{
+			const int32_t* depths = m_depths.data();
+			for (int32_t i = from; i <= to; i++) {
+				minDepth = std::min(minDepth, depths[i]);
+			}
+			return minDepth;
+		};
+
+		const int32_t firstBlock = first >> BlockShift;
+		const int32_t lastBlock = last >> BlockShift;
+		if (firstBlock == lastBlock) {
+			return scan(first, last, INT32_MAX);
+		}
+
+		int32_t minDepth = scan(first, ((firstBlock + 1) << BlockShift) - 1, INT32_MAX);
+		minDepth = scan(lastBlock << BlockShift, last, minDepth);
+		if (lastBlock - firstBlock > 1) {
+			minDepth = std::min(minDepth, GetMinBlockDepth(firstBlock + 1, lastBlock - 1));
+		}
+		return minDepth;
+	}
+
+	int32_t FMazeTreeIndex::GetTree(int32_t position) const
+	{
+		return int32_t(std::upper_bound(m_treeStarts.begin(), m_treeStarts.end(), position) - m_treeStarts.begin()) - 1;
+	}
+
+	/*===================
+	FMazeTreeIndex::GetCellDistance
+
+	Between two different cells in preorder, the shallowest cell after the first and up to the
+	second is a child of their lowest common ancestor (or the second cell itself when the first is
+	its ancestor), so the ancestor's depth is one less.
+	===================*/
+	int32_t FMazeTreeIndex::GetCellDistance(int32_t a, int32_t b) const
+	{
+		int32_t first = m_preorder[a];
+		int32_t last = m_preorder[b];
+		if (first == last) {
+			return 0;
+		}
+		if (first > last) {
+			std::swap(first, last);
+		}
+		if (m_treeStarts.size() > 1 && GetTree(first) != GetTree(last)) {
+			return -1;
+		}
+		const int32_t ancestorDepth = GetMinDepth(first + 1, last) - 1;
+		return m_depths[first] + m_depths[last] - 2 * ancestorDepth;
+	}
+
+	bool FMazeTreeIndex::IsOnPath(int32_t x, int32_t y, int32_t ax, int32_t ay, int32_t bx, int32_t by) const
+	{
+		const int32_t cell = GetCellIndex(x, y);
+		const int32_t a = GetCellIndex(ax, ay);
+		const int32_t b = GetCellIndex(bx, by);
+		const int32_t distance = GetCellDistance(a, b);
+		if (distance < 0) {
+			return false;
+		}
+		const int32_t toCell = GetCellDistance(a, cell);
+		return toCell >= 0 && toCell <= distance && toCell + GetCellDistance(cell, b) == distance;
+	}
+}
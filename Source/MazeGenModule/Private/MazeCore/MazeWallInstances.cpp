@@ -0,0 +1,243 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeWallInstances
+// Purpose: Keeps the wall instances of one orientation in step with walls opened and closed at runtime.
+// License: MIT
+
+#include "MazeCore/MazeWallInstances.h"
+
+#include <climits>
+
+namespace MazeCore
+{
+	/*===================
+	FMazeWallInstances::Build
+
+	The same two scans as the layout's BuildWalls: horizontal lines one at a time, and vertical
+	lines row by row, where a run is only listed once the row past its end is reached.
+	===================*/
+	void FMazeWallInstances::Build(const FMazeGrid& grid, bool bHorizontal, bool bMergeWalls)
+	{
+		m_bHorizontal = bHorizontal;
+		m_bMergeWalls = bMergeWalls;
+		m_lineCount = bHorizontal ? grid.GetHeight() + 1 : grid.GetWidth() + 1;
+		m_lineLength = bHorizontal ? grid.GetWidth() : grid.GetHeight();
+		m_edgeRuns.assign(size_t(m_lineCount) * m_lineLength, -1);
+		m_runs.clear();
+		m_runInstances.clear();
+		m_freeRuns.clear();
+		m_instanceRuns.clear();
+		m_committedCount = 0;
+		m_dirtyInstances.clear();
+		m_bDirty.clear();
+
+		const int32_t maxRun = bMergeWalls ? INT32_MAX : 1;
+		if (bHorizontal)
+		{
+			for (int32_t line = 0; line < m_lineCount; line++)
+			{
+				int32_t x = 0;
+				while (x < m_lineLength)
+				{
+					if (!grid.HasHorizontalWall(x, line)) {
+						x++;
+						continue;
+					}
+					const int32_t start = x;
+					while (x < m_lineLength && x - start < maxRun && grid.HasHorizontalWall(x, line)) {
+						x++;
+					}
+					AddRun(line, start, x - start);
+				}
+			}
+		}
+		else
+		{
+			std::vector<int32_t> runStart(size_t(m_lineCount), -1);
+			for (int32_t y = 0; y <= m_lineLength; y++)
+			{
+				for (int32_t line = 0; line < m_lineCount; line++)
+				{
+					const bool bWall = y < m_lineLength && grid.HasVerticalWall(line, y);
+					int32_t& start = runStart[line];
+					if (start >= 0 && (!bWall || y - start >= maxRun))
+					{
+						AddRun(line, start, y - start);
+						start = -1;
+					}
+					if (bWall && start < 0) {
+						start = y;
+					}
+				}
+			}
+		}
+		Commit();
+	}
+
+	int32_t FMazeWallInstances::AddRun(int32_t line, int32_t start, int32_t length)
+	{
+		int32_t run;
+		if (!m_freeRuns.empty())
+		{
+			run = m_freeRuns.back();
+			m_freeRuns.pop_back();
+			m_runs[run] = { line, start, length };
+		}
+		else
+		{
+			run = int32_t(m_runs.size());
+			m_runs.push_back({ line, start, length });
+			m_runInstances.push_back(-1);
+		}
+		m_runInstances[run] = int32_t(m_instanceRuns.size());
+		m_instanceRuns.push_back(run);
+		AssignEdges(run);
+
+		// After removals the new instance can land in a slot the component still holds
+		MarkDirty(run);
+		return run;
+	}
+
+	void FMazeWallInstances::RemoveRun(int32_t run)
+	{
+		const int32_t instance = m_runInstances[run];
+		const int32_t lastRun = m_instanceRuns.back();
+		if (lastRun != run)
+		{
+			m_instanceRuns[instance] = lastRun;
+			m_runInstances[lastRun] = instance;
+			MarkDirty(lastRun);
+		}
+		m_instanceRuns.pop_back();
+		m_runInstances[run] = -1;
+		m_freeRuns.push_back(run);
+	}
+
+	void FMazeWallInstances::AssignEdges(int32_t run)
+	{
+		const FMazeWallRun& wallRun = m_runs[run];
+		int32_t* edges = &m_edgeRuns[GetEdgeIndex(wallRun.line, wallRun.start)];
+		for (int32_t i = 0; i < wallRun.length; i++) {
+			edges[i] = run;
+		}
+	}
+
+	void FMazeWallInstances::MarkDirty(int32_t run)
+	{
+		const int32_t instance = m_runInstances[run];
+		if (instance < m_committedCount && !m_bDirty[instance])
+		{
+			m_bDirty[instance] = 1;
+			m_dirtyInstances.push_back(instance);
+		}
+	}
+
+	/*===================
+	FMazeWallInstances::SetWall
+
+	Closing an edge extends the run on either side, or joins both; opening one shortens its run,
+	removes it, or splits it in two. When two runs join, or one splits, the shorter part is the
+	one whose edges are relabelled, so an edit costs at most half the run it touches.
+	===================*/
+	bool FMazeWallInstances::SetWall(int32_t line, int32_t position, bool bWall)
+	{
+		const int32_t edge = GetEdgeIndex(line, position);
+		if ((m_edgeRuns[edge] >= 0) == bWall) {
+			return false;
+		}
+
+		if (bWall)
+		{
+			const int32_t before = m_bMergeWalls && position > 0 ? m_edgeRuns[edge - 1] : -1;
+			const int32_t after = m_bMergeWalls && position < m_lineLength - 1 ? m_edgeRuns[edge + 1] : -1;
+			if (before < 0 && after < 0) {
+				AddRun(line, position, 1);
+			}
+			else if (after < 0)
+			{
+				m_runs[before].length++;
+				m_edgeRuns[edge] = before;
+				MarkDirty(before);
+			}
+			else if (before < 0)
+			{
+				m_runs[after].start--;
+				m_runs[after].length++;
+				m_edgeRuns[edge] = after;
+				MarkDirty(after);
+			}
+			else
+			{
+				const bool bKeepBefore = m_runs[before].length >= m_runs[after].length;
+				const int32_t kept = bKeepBefore ? before : after;
+				const int32_t joined = bKeepBefore ? after : before;
+				const FMazeWallRun joinedRun = m_runs[joined];
+				m_runs[kept].start = m_runs[before].start;
+				m_runs[kept].length = m_runs[before].length + 1 + m_runs[after].length;
+				int32_t* edges = &m_edgeRuns[GetEdgeIndex(line, joinedRun.start)];
+				for (int32_t i = 0; i < joinedRun.length; i++) {
+					edges[i] = kept;
+				}
+				m_edgeRuns[edge] = kept;
+				MarkDirty(kept);
+				RemoveRun(joined);
+			}
+			return true;
+		}
+
+		const int32_t run = m_edgeRuns[edge];
+		m_edgeRuns[edge] = -1;
+		FMazeWallRun& wallRun = m_runs[run];
+		const int32_t beforeLength = position - wallRun.start;
+		const int32_t afterLength = wallRun.start + wallRun.length - 1 - position;
+		if (beforeLength == 0 && afterLength == 0) {
+			RemoveRun(run);
+		}
+		else if (beforeLength == 0 || afterLength == 0)
+		{
+			wallRun.start += beforeLength == 0 ? 1 : 0;
+			wallRun.length--;
+			MarkDirty(run);
+		}
+		else
+		{
+			// The run keeps the longer part and the shorter part becomes a new run
+			const int32_t start = wallRun.start;
+			if (beforeLength >= afterLength)
+			{
+				wallRun.length = beforeLength;
+				MarkDirty(run);
+				AddRun(line, position + 1, afterLength);
+			}
+			else
+			{
+				wallRun.start = position + 1;
+				wallRun.length = afterLength;
+				MarkDirty(run);
+				AddRun(line, start, beforeLength);
+			}
+		}
+		return true;
+	}
+
+	int32_t FMazeWallInstances::GetInstanceAt(int32_t line, int32_t position) const
+	{
+		const int32_t run = m_edgeRuns[GetEdgeIndex(line, position)];
+		return run >= 0 ? m_runInstances[run] : -1;
+	}
+
+	void FMazeWallInstances::Commit()
+	{
+		for (const int32_t instance : m_dirtyInstances) {
+			m_bDirty[instance] = 0;
+		}
+		m_dirtyInstances.clear();
+		m_committedCount = GetInstanceCount();
+		m_bDirty.resize(size_t(m_committedCount), 0);
+	}
+
+	size_t FMazeWallInstances::GetAllocatedSize() const
+	{
+		return (m_edgeRuns.capacity() + m_runInstances.capacity() + m_freeRuns.capacity() + m_instanceRuns.capacity()
+			+ m_dirtyInstances.capacity()) * sizeof(int32_t) + m_runs.capacity() * sizeof(FMazeWallRun) + m_bDirty.capacity();
+	}
+}
@@ -0,0 +1,78 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeFileIO
+// Purpose: Saves and loads maze files through the engine's file system.
+// License: MIT
+
+#include "MazeFileIO.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FString FMazeFileIO::ResolvePath(const FString& filePath)
+{
+	return FPaths::IsRelative(filePath) ? FPaths::Combine(FPaths::ProjectDir(), filePath) : filePath;
+}
+
+bool FMazeFileIO::Save(const FString& filePath, const MazeCore::FMazeGrid& grid, const MazeCore::FMazeFileHeader& header)
+{
+	TArray64<uint8> data;
+	data.SetNumUninitialized(int64(MazeCore::GetMazeFileSize(header)));
+	MazeCore::WriteMazeFile(grid, header, data.GetData());
+	return FFileHelper::SaveArrayToFile(data, *ResolvePath(filePath));
+}
+
+bool FMazeFileIO::SaveEllerStream(const FString& filePath, int32 width, int32 height, uint64 seed, MazeCore::FMazeFileHeader& outHeader)
+{
+	const FString path = ResolvePath(filePath);
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(path), true);
+	TUniquePtr<IFileHandle> file(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*path));
+	if (!file) {
+		return false;
+	}
+
+	// Sections come in order, and the header comes last at the start of the file
+	const bool bWritten = MazeCore::StreamEllerMazeFile(width, height, seed, [&file](size_t offset, const uint8_t* data, size_t size)
+	{
+		if (file->Tell() != int64(offset) && !file->Seek(int64(offset))) {
+			return false;
+		}
+		return file->Write(data, int64(size));
+	}, outHeader);
+	const bool bFlushed = bWritten && file->Flush();
+	file.Reset();
+
+	if (!bFlushed) {
+		IFileManager::Get().Delete(*path);
+	}
+	return bFlushed;
+}
+
+/*===================
+FMazeFileIO::Load
+
+Maps the whole file and copies the planes out of the mapping, so nothing is read into an
+intermediate buffer. Files that cannot be mapped (inside a pak file, or on platforms without
+mapping) are read into memory instead.
+===================*/
+bool FMazeFileIO::Load(const FString& filePath, MazeCore::FMazeGrid& outGrid, MazeCore::FMazeFileHeader& outHeader)
+{
+	const FString path = ResolvePath(filePath);
+	IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// The region is declared after the handle so it is unmapped first
+	TUniquePtr<IMappedFileHandle> mappedFile(platformFile.OpenMapped(*path));
+	if (mappedFile)
+	{
+		TUniquePtr<IMappedFileRegion> region(mappedFile->MapRegion(0, mappedFile->GetFileSize()));
+		if (region) {
+			return MazeCore::ReadMazeFile(region->GetMappedPtr(), size_t(region->GetMappedSize()), outGrid, outHeader);
+		}
+	}
+
+	TArray64<uint8> data;
+	if (!FFileHelper::LoadFileToArray(data, *path, FILEREAD_Silent)) {
+		return false;
+	}
+	return MazeCore::ReadMazeFile(data.GetData(), size_t(data.Num()), outGrid, outHeader);
+}
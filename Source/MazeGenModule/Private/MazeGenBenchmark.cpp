@@ -0,0 +1,67 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Console command that benchmarks maze generation without spawning an actor.
+// Tools/MazeBench builds the same benchmark without the engine.
+// Run headless with:
+//   UnrealEditor-Cmd SimpleMazeGenerator.uproject -ExecCmds="MazeGen.Benchmark 8192,Quit" -nullrhi -unattended
+// License: MIT
+
+#include "MazeCore/MazeGenerators.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+
+/*===================
+RunMazeGenBenchmark
+
+Generates square mazes with the iterative backtracker and Wilson's algorithm, doubling the size
+from 128 up to the requested maximum (default 8192), and logs the throughput in cells per second
+together with the memory held by the grid and the generator's per-cell scratch array, and the
+peak physical memory of the process.
+===================*/
+static void RunMazeGenBenchmark(const TArray<FString>& args)
+{
+	int maxSize = 8192;
+	if (args.Num() > 0) {
+		maxSize = FCString::Atoi(*args[0]);
+	}
+
+	// Per-cell scratch: the backtracker's stack holds int32 cell indices, Wilson keeps a direction byte
+	struct FBenchAlgorithm
+	{
+		MazeCore::EMazeGenAlgorithm algorithm;
+		int32 scratchBytesPerCell;
+	};
+	const FBenchAlgorithm algorithms[] = {
+		{ MazeCore::EMazeGenAlgorithm::IterativeBacktracker, int32(sizeof(int32)) },
+		{ MazeCore::EMazeGenAlgorithm::Wilson, int32(sizeof(uint8)) }
+	};
+
+	for (const FBenchAlgorithm& bench : algorithms)
+	{
+		UE_LOG(LogTemp, Display, TEXT("MazeGen benchmark: %hs, 128 to %d"), MazeCore::GetAlgorithmName(bench.algorithm), maxSize);
+
+		for (int size = 128; size <= maxSize; size *= 2)
+		{
+			MazeCore::FMazeGrid mazeGrid;
+			mazeGrid.Init(size, size);
+			MazeCore::FMazeRandom random(size);
+
+			const double startTime = FPlatformTime::Seconds();
+			MazeCore::GenerateMaze(mazeGrid, random, bench.algorithm, 0, 0);
+			const double elapsed = FPlatformTime::Seconds() - startTime;
+
+			const double cells = double(size) * double(size);
+			const double workingSetMB = (mazeGrid.GetAllocatedSize() + cells * bench.scratchBytesPerCell) / (1024.0 * 1024.0);
+			const FPlatformMemoryStats memoryStats = FPlatformMemory::GetStats();
+
+			UE_LOG(LogTemp, Display, TEXT("%5d x %-5d  %8.2f ms  %8.2f Mcells/s  grid+scratch %8.1f MB  peak %8.1f MB"),
+				size, size, elapsed * 1000.0, cells / elapsed / 1.0e6, workingSetMB,
+				memoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+		}
+	}
+}
+
+static FAutoConsoleCommand GMazeGenBenchmarkCommand(
+	TEXT("MazeGen.Benchmark"),
+	TEXT("Benchmarks maze generation. Usage: MazeGen.Benchmark [MaxSize]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunMazeGenBenchmark));
@@ -0,0 +1,483 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeGenCache
+// Purpose: Memory and disk cache of generated mazes, keyed on every setting that affects the result.
+// License: MIT
+
+#include "MazeGenCache.h"
+#include "MazeCore/MazeFile.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<int32> CVarMazeCacheMaxMemoryMB(
+	TEXT("MazeGen.Cache.MaxMemoryMB"),
+	512,
+	TEXT("Memory held by cached mazes before the least recently used ones are dropped."));
+
+static TAutoConsoleVariable<int32> CVarMazeCacheMaxDiskMB(
+	TEXT("MazeGen.Cache.MaxDiskMB"),
+	2048,
+	TEXT("Size of Saved/MazeCache before the least recently used cache files are deleted (0 disables the disk cache)."));
+
+// Bump whenever a generator or the layout changes its output, so old cache files are ignored
+static constexpr uint32 MazeCacheVersion = 1;
+
+// "MZC1" in file byte order
+static constexpr uint32 MazeCacheFileMagic = 0x31435A4D;
+
+static const TCHAR* MazeCacheFileExtension = TEXT(".mazecache");
+
+// Fixed header of a cache file. The maze file (MazeCore/MazeFile.h) follows for backtrace mazes,
+// then the floor, default wall and rotated wall transforms.
+struct FMazeCacheFileHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 kind;
+	uint32 algorithm;
+	uint64 seed;
+	int32 width;
+	int32 height;
+	uint64 layoutHash;
+	int32 floorCount;
+	int32 defaultWallCount;
+	int32 rotatedWallCount;
+	uint32 reserved;
+	uint64 mazeFileSize;
+};
+static_assert(sizeof(FMazeCacheFileHeader) == 64, "The cache file header is 64 bytes on disk");
+
+// Transforms are stored in single precision. Locations and scales come from float values in the
+// layout, so only the rotations of turn maze walls are rounded.
+struct FMazeCachedTransform
+{
+	float rotation[4];
+	float translation[3];
+	float scale[3];
+};
+
+/*===================
+HashCacheValue
+
+FNV-1a over the bytes of a value, least significant first.
+===================*/
+static uint64 HashCacheValue(uint64 hash, uint64 value, int32 byteCount)
+{
+	for (int32 i = 0; i < byteCount; i++)
+	{
+		hash ^= (value >> (i * 8)) & 0xff;
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static uint64 HashCacheFloat(uint64 hash, float value)
+{
+	uint32 bits;
+	FMemory::Memcpy(&bits, &value, sizeof(bits));
+	return HashCacheValue(hash, bits, 4);
+}
+
+static uint64 HashCacheDouble(uint64 hash, double value)
+{
+	uint64 bits;
+	FMemory::Memcpy(&bits, &value, sizeof(bits));
+	return HashCacheValue(hash, bits, 8);
+}
+
+FMazeGenCacheKey FMazeGenCacheKey::MakeBacktrace(MazeCore::EMazeGenAlgorithm algorithm, uint64 seed, int32 width, int32 height,
+	const MazeCore::FMazeLayoutSettings& settings)
+{
+	FMazeGenCacheKey key;
+	key.kind = EMazeCacheKind::Backtrace;
+	key.algorithm = uint32(algorithm);
+	key.seed = seed;
+	key.width = width;
+	key.height = height;
+
+	uint64 hash = HashCacheValue(0xcbf29ce484222325ull, MazeCacheVersion, 4);
+	hash = HashCacheFloat(hash, settings.positionScaling);
+	hash = HashCacheFloat(hash, settings.meshScaleX);
+	hash = HashCacheFloat(hash, settings.meshScaleY);
+	hash = HashCacheFloat(hash, settings.meshScaleZ);
+	hash = HashCacheFloat(hash, settings.zOffset);
+	hash = HashCacheValue(hash, settings.bMergeWalls ? 1 : 0, 1);
+	key.layoutHash = HashCacheValue(hash, uint64(settings.floorLayout), 1);
+	return key;
+}
+
+FMazeGenCacheKey FMazeGenCacheKey::MakeTurn(uint64 seed, int32 width, int32 height, float positionScaling, float wallRotationDeg,
+	const FVector& meshScaling, EMazeFloorMode floorMode)
+{
+	FMazeGenCacheKey key;
+	key.kind = EMazeCacheKind::Turn;
+	key.seed = seed;
+	key.width = width;
+	key.height = height;
+
+	uint64 hash = HashCacheValue(0xcbf29ce484222325ull, MazeCacheVersion, 4);
+	hash = HashCacheFloat(hash, positionScaling);
+	hash = HashCacheFloat(hash, wallRotationDeg);
+	hash = HashCacheDouble(hash, meshScaling.X);
+	hash = HashCacheDouble(hash, meshScaling.Y);
+	hash = HashCacheDouble(hash, meshScaling.Z);
+	key.layoutHash = HashCacheValue(hash, uint64(floorMode), 1);
+	return key;
+}
+
+uint64 FMazeGenCacheKey::GetHash64() const
+{
+	uint64 hash = HashCacheValue(0xcbf29ce484222325ull, uint64(kind), 1);
+	hash = HashCacheValue(hash, algorithm, 4);
+	hash = HashCacheValue(hash, seed, 8);
+	hash = HashCacheValue(hash, uint32(width), 4);
+	hash = HashCacheValue(hash, uint32(height), 4);
+	return HashCacheValue(hash, layoutHash, 8);
+}
+
+int64 FMazeGenCacheEntry::GetAllocatedSize() const
+{
+	return int64(grid.GetAllocatedSize()) + instances.floors.GetAllocatedSize() + instances.defaultWalls.GetAllocatedSize()
+		+ instances.rotatedWalls.GetAllocatedSize();
+}
+
+FMazeGenCache& FMazeGenCache::Get()
+{
+	static FMazeGenCache cache;
+	return cache;
+}
+
+FString FMazeGenCache::GetCacheDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MazeCache"));
+}
+
+FString FMazeGenCache::GetCacheFilePath(const FMazeGenCacheKey& key)
+{
+	return FPaths::Combine(GetCacheDirectory(), FString::Printf(TEXT("%016llx%s"), key.GetHash64(), MazeCacheFileExtension));
+}
+
+/*===================
+FMazeGenCache::Find
+
+The lock is not held while a cache file is read, so two threads missing the same key at once may
+both read it; the second simply replaces the first in memory.
+===================*/
+FMazeGenCacheEntryPtr FMazeGenCache::Find(const FMazeGenCacheKey& key)
+{
+	{
+		FScopeLock lock(&m_lock);
+		if (FSlot* slot = m_entries.Find(key))
+		{
+			slot->lastUse = ++m_useCounter;
+			m_stats.memoryHits++;
+			return slot->entry;
+		}
+	}
+
+	FMazeGenCacheEntryPtr entry = LoadFromDisk(key);
+
+	FScopeLock lock(&m_lock);
+	if (entry.IsValid())
+	{
+		m_stats.diskHits++;
+		AddToMemory(key, entry);
+	}
+	else {
+		m_stats.misses++;
+	}
+	return entry;
+}
+
+void FMazeGenCache::Add(const FMazeGenCacheKey& key, const FMazeGenCacheEntryPtr& entry)
+{
+	if (!entry.IsValid()) {
+		return;
+	}
+	{
+		FScopeLock lock(&m_lock);
+		AddToMemory(key, entry);
+	}
+
+	if (CVarMazeCacheMaxDiskMB.GetValueOnAnyThread() > 0)
+	{
+		// The entry is immutable, so the writer can share it with the game
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [key, entry]()
+		{
+			if (SaveToDisk(key, *entry)) {
+				TrimDisk();
+			}
+		});
+	}
+}
+
+/*===================
+FMazeGenCache::AddToMemory
+
+Entries larger than the whole cap are only kept on disk. Otherwise the least recently used
+entries are dropped until the new one fits. The cache holds few entries (each is a whole maze),
+so finding the oldest is a plain scan.
+===================*/
+void FMazeGenCache::AddToMemory(const FMazeGenCacheKey& key, const FMazeGenCacheEntryPtr& entry)
+{
+	const int64 maxBytes = int64(FMath::Max(CVarMazeCacheMaxMemoryMB.GetValueOnAnyThread(), 0)) << 20;
+
+	if (const FSlot* existing = m_entries.Find(key))
+	{
+		m_stats.memoryBytes -= existing->bytes;
+		m_entries.Remove(key);
+	}
+
+	const int64 bytes = entry->GetAllocatedSize();
+	if (bytes > maxBytes)
+	{
+		m_stats.entryCount = m_entries.Num();
+		return;
+	}
+
+	while (m_stats.memoryBytes + bytes > maxBytes && m_entries.Num() > 0)
+	{
+		FMazeGenCacheKey oldestKey;
+		int64 oldestBytes = 0;
+		uint64 oldestUse = MAX_uint64;
+		for (const TPair<FMazeGenCacheKey, FSlot>& pair : m_entries)
+		{
+			if (pair.Value.lastUse < oldestUse)
+			{
+				oldestUse = pair.Value.lastUse;
+				oldestKey = pair.Key;
+				oldestBytes = pair.Value.bytes;
+			}
+		}
+		m_entries.Remove(oldestKey);
+		m_stats.memoryBytes -= oldestBytes;
+		m_stats.evictions++;
+	}
+
+	FSlot& slot = m_entries.Add(key);
+	slot.entry = entry;
+	slot.bytes = bytes;
+	slot.lastUse = ++m_useCounter;
+	m_stats.memoryBytes += bytes;
+	m_stats.entryCount = m_entries.Num();
+}
+
+void FMazeGenCache::Clear(bool bDeleteFiles)
+{
+	{
+		FScopeLock lock(&m_lock);
+		m_entries.Empty();
+		m_stats.memoryBytes = 0;
+		m_stats.entryCount = 0;
+	}
+	if (bDeleteFiles) {
+		IFileManager::Get().DeleteDirectory(*GetCacheDirectory(), false, true);
+	}
+}
+
+FMazeGenCacheStats FMazeGenCache::GetStats() const
+{
+	FScopeLock lock(&m_lock);
+	return m_stats;
+}
+
+/*===================
+FMazeGenCache::SaveToDisk
+
+Builds the whole file in memory and writes it under a temporary name first, so another process
+(a dedicated server next to PIE) never reads half a file.
+===================*/
+bool FMazeGenCache::SaveToDisk(const FMazeGenCacheKey& key, const FMazeGenCacheEntry& entry)
+{
+	FMazeCacheFileHeader header = {};
+	header.magic = MazeCacheFileMagic;
+	header.version = MazeCacheVersion;
+	header.kind = uint32(key.kind);
+	header.algorithm = key.algorithm;
+	header.seed = key.seed;
+	header.width = key.width;
+	header.height = key.height;
+	header.layoutHash = key.layoutHash;
+	header.floorCount = entry.instances.floors.Num();
+	header.defaultWallCount = entry.instances.defaultWalls.Num();
+	header.rotatedWallCount = entry.instances.rotatedWalls.Num();
+
+	MazeCore::FMazeFileHeader mazeHeader = {};
+	if (entry.grid.GetCellCount() > 0)
+	{
+		mazeHeader = MazeCore::MakeMazeFileHeader(entry.grid, key.seed, MazeCore::EMazeGenAlgorithm(key.algorithm), entry.endpoints);
+		header.mazeFileSize = MazeCore::GetMazeFileSize(mazeHeader);
+	}
+
+	const int64 transformCount = int64(header.floorCount) + header.defaultWallCount + header.rotatedWallCount;
+	TArray64<uint8> data;
+	data.SetNumUninitialized(int64(sizeof(header)) + int64(header.mazeFileSize) + transformCount * int64(sizeof(FMazeCachedTransform)));
+
+	uint8* write = data.GetData();
+	FMemory::Memcpy(write, &header, sizeof(header));
+	write += sizeof(header);
+	if (header.mazeFileSize > 0)
+	{
+		MazeCore::WriteMazeFile(entry.grid, mazeHeader, write);
+		write += header.mazeFileSize;
+	}
+
+	FMazeCachedTransform* cached = reinterpret_cast<FMazeCachedTransform*>(write);
+	for (const TArray<FTransform>* transforms : { &entry.instances.floors, &entry.instances.defaultWalls, &entry.instances.rotatedWalls })
+	{
+		for (const FTransform& transform : *transforms)
+		{
+			const FQuat rotation = transform.GetRotation();
+			const FVector translation = transform.GetTranslation();
+			const FVector scale = transform.GetScale3D();
+			*cached++ = { { float(rotation.X), float(rotation.Y), float(rotation.Z), float(rotation.W) },
+				{ float(translation.X), float(translation.Y), float(translation.Z) },
+				{ float(scale.X), float(scale.Y), float(scale.Z) } };
+		}
+	}
+
+	const FString path = GetCacheFilePath(key);
+	const FString tempPath = FString::Printf(TEXT("%s.%u_%u.tmp"), *path, FPlatformProcess::GetCurrentProcessId(), FPlatformTLS::GetCurrentThreadId());
+	if (!FFileHelper::SaveArrayToFile(data, *tempPath)) {
+		return false;
+	}
+	if (!IFileManager::Get().Move(*path, *tempPath, true, true, false, true))
+	{
+		IFileManager::Get().Delete(*tempPath, false, true, true);
+		return false;
+	}
+	return true;
+}
+
+/*===================
+FMazeGenCache::LoadFromDisk
+
+Every size is checked against the file before anything is copied out of it. A hit refreshes the
+file's time stamp, which TrimDisk uses as its last use.
+===================*/
+FMazeGenCacheEntryPtr FMazeGenCache::LoadFromDisk(const FMazeGenCacheKey& key)
+{
+	if (CVarMazeCacheMaxDiskMB.GetValueOnAnyThread() <= 0) {
+		return nullptr;
+	}
+
+	const FString path = GetCacheFilePath(key);
+	TArray64<uint8> data;
+	if (!FFileHelper::LoadFileToArray(data, *path, FILEREAD_Silent) || data.Num() < int64(sizeof(FMazeCacheFileHeader))) {
+		return nullptr;
+	}
+
+	FMazeCacheFileHeader header;
+	FMemory::Memcpy(&header, data.GetData(), sizeof(header));
+	if (header.magic != MazeCacheFileMagic || header.version != MazeCacheVersion || header.kind != uint32(key.kind)
+		|| header.algorithm != key.algorithm || header.seed != key.seed || header.width != key.width || header.height != key.height
+		|| header.layoutHash != key.layoutHash || header.floorCount < 0 || header.defaultWallCount < 0 || header.rotatedWallCount < 0) {
+		return nullptr;
+	}
+
+	const int64 transformCount = int64(header.floorCount) + header.defaultWallCount + header.rotatedWallCount;
+	if (data.Num() != int64(sizeof(header)) + int64(header.mazeFileSize) + transformCount * int64(sizeof(FMazeCachedTransform))) {
+		return nullptr;
+	}
+
+	TSharedPtr<FMazeGenCacheEntry, ESPMode::ThreadSafe> entry = MakeShared<FMazeGenCacheEntry, ESPMode::ThreadSafe>();
+	const uint8* read = data.GetData() + sizeof(header);
+	if (header.mazeFileSize > 0)
+	{
+		MazeCore::FMazeFileHeader mazeHeader;
+		if (!MazeCore::ReadMazeFile(read, size_t(header.mazeFileSize), entry->grid, mazeHeader)
+			|| mazeHeader.width != key.width || mazeHeader.height != key.height) {
+			return nullptr;
+		}
+		entry->endpoints = MazeCore::GetMazeFileEndpoints(mazeHeader);
+		read += header.mazeFileSize;
+	}
+
+	const FMazeCachedTransform* cached = reinterpret_cast<const FMazeCachedTransform*>(read);
+	auto readTransforms = [&cached](int32 count, TArray<FTransform>& outTransforms)
+	{
+		outTransforms.Reset(count);
+		for (int32 i = 0; i < count; i++, cached++)
+		{
+			outTransforms.Emplace(FQuat(cached->rotation[0], cached->rotation[1], cached->rotation[2], cached->rotation[3]),
+				FVector(cached->translation[0], cached->translation[1], cached->translation[2]),
+				FVector(cached->scale[0], cached->scale[1], cached->scale[2]));
+		}
+	};
+	readTransforms(header.floorCount, entry->instances.floors);
+	readTransforms(header.defaultWallCount, entry->instances.defaultWalls);
+	readTransforms(header.rotatedWallCount, entry->instances.rotatedWalls);
+
+	IFileManager::Get().SetTimeStamp(*path, FDateTime::UtcNow());
+	return entry;
+}
+
+void FMazeGenCache::TrimDisk()
+{
+	const int64 maxBytes = int64(CVarMazeCacheMaxDiskMB.GetValueOnAnyThread()) << 20;
+	const FString directory = GetCacheDirectory();
+
+	TArray<FString> fileNames;
+	IFileManager::Get().FindFiles(fileNames, *directory, MazeCacheFileExtension);
+
+	struct FCacheFile
+	{
+		FString path;
+		int64 size;
+		FDateTime lastUse;
+	};
+	TArray<FCacheFile> files;
+	int64 totalBytes = 0;
+	for (const FString& fileName : fileNames)
+	{
+		FString path = FPaths::Combine(directory, fileName);
+		const int64 size = IFileManager::Get().FileSize(*path);
+		if (size < 0) {
+			continue;
+		}
+		totalBytes += size;
+		const FDateTime lastUse = IFileManager::Get().GetTimeStamp(*path);
+		files.Add({ MoveTemp(path), size, lastUse });
+	}
+	if (totalBytes <= maxBytes) {
+		return;
+	}
+
+	files.Sort([](const FCacheFile& a, const FCacheFile& b) { return a.lastUse < b.lastUse; });
+	for (const FCacheFile& file : files)
+	{
+		if (totalBytes <= maxBytes) {
+			break;
+		}
+		if (IFileManager::Get().Delete(*file.path, false, true, true)) {
+			totalBytes -= file.size;
+		}
+	}
+}
+
+/*===================
+LogMazeCacheStats
+===================*/
+static void LogMazeCacheStats()
+{
+	const FMazeGenCacheStats stats = FMazeGenCache::Get().GetStats();
+	const int64 lookups = stats.memoryHits + stats.diskHits + stats.misses;
+	UE_LOG(LogTemp, Display, TEXT("Maze cache: %lld memory hits, %lld disk hits, %lld misses (%.1f%% hit rate), %lld evictions, %d entries using %.1f MB"),
+		stats.memoryHits, stats.diskHits, stats.misses, lookups > 0 ? 100.0 * double(stats.memoryHits + stats.diskHits) / double(lookups) : 0.0,
+		stats.evictions, stats.entryCount, double(stats.memoryBytes) / (1024.0 * 1024.0));
+}
+
+static FAutoConsoleCommand GMazeCacheStatsCommand(
+	TEXT("MazeGen.Cache.Stats"),
+	TEXT("Logs maze cache hits, misses and memory use."),
+	FConsoleCommandDelegate::CreateStatic(&LogMazeCacheStats));
+
+static FAutoConsoleCommand GMazeCacheClearCommand(
+	TEXT("MazeGen.Cache.Clear"),
+	TEXT("Empties the maze cache in memory and deletes its files."),
+	FConsoleCommandDelegate::CreateLambda([]() { FMazeGenCache::Get().Clear(true); }));
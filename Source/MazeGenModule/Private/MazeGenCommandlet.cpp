@@ -0,0 +1,151 @@
+// Author: Joshua Hall - Griffith University
+// Class: UMazeGenCommandlet
+// Purpose: Batch generation of maze files without a world.
+// License: MIT
+
+#include "MazeGenCommandlet.h"
+#include "MazeCore/MazeGenerators.h"
+#include "MazeFileIO.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+UMazeGenCommandlet::UMazeGenCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+/*===================
+ParseAlgorithm
+
+Takes an algorithm name as GetAlgorithmName prints it (such as "wilson") or its number.
+The recursive backtracker is refused: it recurses once per cell and overflows a task's stack.
+===================*/
+static bool ParseAlgorithm(const FString& value, MazeCore::EMazeGenAlgorithm& outAlgorithm)
+{
+	for (uint8 index = 0; index <= uint8(MazeCore::EMazeGenAlgorithm::Prim); index++)
+	{
+		const MazeCore::EMazeGenAlgorithm algorithm = MazeCore::EMazeGenAlgorithm(index);
+		if (value.Equals(ANSI_TO_TCHAR(MazeCore::GetAlgorithmName(algorithm)), ESearchCase::IgnoreCase) || value == FString::FromInt(index))
+		{
+			outAlgorithm = algorithm;
+			return algorithm != MazeCore::EMazeGenAlgorithm::RecursiveBacktracker;
+		}
+	}
+	return false;
+}
+
+/*===================
+UMazeGenCommandlet::Main
+
+-algorithm=NAME   generator, default iterative-backtracker
+-width=N          maze width in cells, default 128
+-height=N         maze height in cells, default the width
+-seed=N           first seed, default 0
+-count=N          number of mazes, one per seed, default 1
+-out=DIR          output directory, relative to the project, default Saved/Mazes
+
+Every worker keeps its grid between mazes, so the wall planes are only allocated for its first
+maze; the generators still allocate their per-cell scratch and the file buffer for every maze.
+The workers already use every core, so a parallel-tiles maze carves its tiles on its own worker
+unless it is the only maze. Eller mazes are streamed to their files a section of
+rows at a time and never held whole. Files are named <algorithm>_<width>x<height>_<seed>.maze and load with
+ImportMaze or the mazeFile setting.
+===================*/
+int32 UMazeGenCommandlet::Main(const FString& Params)
+{
+	const TCHAR* params = *Params;
+
+	FString algorithmName = ANSI_TO_TCHAR(MazeCore::GetAlgorithmName(MazeCore::EMazeGenAlgorithm::IterativeBacktracker));
+	FParse::Value(params, TEXT("algorithm="), algorithmName);
+	MazeCore::EMazeGenAlgorithm algorithm = MazeCore::EMazeGenAlgorithm::IterativeBacktracker;
+	if (!ParseAlgorithm(algorithmName, algorithm))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeGen: unknown or unsupported algorithm %s"), *algorithmName);
+		return 1;
+	}
+
+	int32 width = 128;
+	FParse::Value(params, TEXT("width="), width);
+	int32 height = width;
+	FParse::Value(params, TEXT("height="), height);
+	uint64 firstSeed = 0;
+	FParse::Value(params, TEXT("seed="), firstSeed);
+	int32 count = 1;
+	FParse::Value(params, TEXT("count="), count);
+	FString outDir = TEXT("Saved/Mazes");
+	FParse::Value(params, TEXT("out="), outDir);
+
+	if (width <= 0 || height <= 0 || count <= 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeGen: width, height and count must be positive"));
+		return 1;
+	}
+	if (int64(width) * height > MAX_int32)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeGen: %d x %d has more cells than a maze can hold"), width, height);
+		return 1;
+	}
+
+	// Made once up front rather than racing from every task
+	outDir = FMazeFileIO::ResolvePath(outDir);
+	if (!IFileManager::Get().MakeDirectory(*outDir, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeGen: could not create %s"), *outDir);
+		return 1;
+	}
+
+	const FString prefix = FString::Printf(TEXT("%hs_%dx%d_"), MazeCore::GetAlgorithmName(algorithm), width, height);
+	UE_LOG(LogTemp, Display, TEXT("MazeGen: %d mazes %s%llu to %s%llu.maze in %s"), count, *prefix, firstSeed, *prefix, firstSeed + uint64(count - 1), *outDir);
+
+	struct FWorkerContext
+	{
+		MazeCore::FMazeGrid grid;
+	};
+	TArray<FWorkerContext> contexts;
+	std::atomic<int32> failedCount(0);
+	std::atomic<int64> writtenBytes(0);
+
+	const int32 tileThreads = count == 1 ? 0 : 1;
+	const double startTime = FPlatformTime::Seconds();
+	ParallelForWithTaskContext(contexts, count, [&](FWorkerContext& context, int32 index)
+	{
+		const uint64 mazeSeed = firstSeed + uint64(index);
+		const FString filePath = FPaths::Combine(outDir, FString::Printf(TEXT("%s%llu.maze"), *prefix, mazeSeed));
+
+		// Eller's rows go straight to the file, so the worker never holds the maze
+		MazeCore::FMazeFileHeader header;
+		bool bSaved;
+		if (algorithm == MazeCore::EMazeGenAlgorithm::Eller) {
+			bSaved = FMazeFileIO::SaveEllerStream(filePath, width, height, mazeSeed, header);
+		}
+		else
+		{
+			const MazeCore::FMazeEndpoints endpoints = MazeCore::GenerateMazeFromSeed(context.grid, width, height, algorithm, mazeSeed, nullptr, tileThreads);
+			header = MazeCore::MakeMazeFileHeader(context.grid, mazeSeed, algorithm, endpoints);
+			bSaved = FMazeFileIO::Save(filePath, context.grid, header);
+		}
+
+		if (bSaved) {
+			writtenBytes += int64(MazeCore::GetMazeFileSize(header));
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("MazeGen: could not write %s"), *filePath);
+			failedCount++;
+		}
+	});
+	const double elapsed = FMath::Max(FPlatformTime::Seconds() - startTime, 1.0e-9);
+
+	const double cells = double(width) * double(height) * count;
+	UE_LOG(LogTemp, Display, TEXT("MazeGen: %d mazes in %.2f s on %d workers, %.1f mazes/s, %.2f Mcells/s, %.1f MB written"),
+		count - failedCount.load(), elapsed, contexts.Num(), count / elapsed, cells / elapsed / 1.0e6, writtenBytes.load() / (1024.0 * 1024.0));
+
+	return failedCount.load() == 0 ? 0 : 1;
+}
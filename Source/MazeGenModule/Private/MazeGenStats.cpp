@@ -0,0 +1,62 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeGenStats
+// Purpose: Definitions of the MazeGen stats and trace channel, and the generation summary's log line.
+// License: MIT
+
+#include "MazeGenStats.h"
+
+DEFINE_STAT(STAT_MazeGen_GenerateMeshes);
+DEFINE_STAT(STAT_MazeGen_AllocateGrid);
+DEFINE_STAT(STAT_MazeGen_GenerateMaze);
+DEFINE_STAT(STAT_MazeGen_InitSolvers);
+DEFINE_STAT(STAT_MazeGen_BuildTransforms);
+DEFINE_STAT(STAT_MazeGen_AddInstances);
+DEFINE_STAT(STAT_MazeGen_FlushWallEdits);
+DEFINE_STAT(STAT_MazeGen_RefreshSolvers);
+DEFINE_STAT(STAT_MazeGen_ShiftRegion);
+DEFINE_STAT(STAT_MazeGen_WallInstanceUpdates);
+DEFINE_STAT(STAT_MazeGen_Cells);
+DEFINE_STAT(STAT_MazeGen_Walls);
+DEFINE_STAT(STAT_MazeGen_WallInstances);
+DEFINE_STAT(STAT_MazeGen_FloorInstances);
+DEFINE_STAT(STAT_MazeGen_GridMemory);
+DEFINE_STAT(STAT_MazeGen_TransformMemory);
+DEFINE_STAT(STAT_MazeGen_SolverMemory);
+
+UE_TRACE_CHANNEL_DEFINE(MazeGenChannel);
+
+void FMazeGenStats::AddMaze(const FMazeGenerationSummary& summary)
+{
+	INC_DWORD_STAT_BY(STAT_MazeGen_Cells, summary.cellCount);
+	INC_DWORD_STAT_BY(STAT_MazeGen_Walls, summary.wallCount);
+	INC_DWORD_STAT_BY(STAT_MazeGen_WallInstances, summary.wallInstanceCount);
+	INC_DWORD_STAT_BY(STAT_MazeGen_FloorInstances, summary.floorInstanceCount);
+	INC_MEMORY_STAT_BY(STAT_MazeGen_GridMemory, summary.gridBytes);
+	INC_MEMORY_STAT_BY(STAT_MazeGen_TransformMemory, summary.transformBytes);
+	INC_MEMORY_STAT_BY(STAT_MazeGen_SolverMemory, summary.solverBytes);
+}
+
+void FMazeGenStats::RemoveMaze(const FMazeGenerationSummary& summary)
+{
+	DEC_DWORD_STAT_BY(STAT_MazeGen_Cells, summary.cellCount);
+	DEC_DWORD_STAT_BY(STAT_MazeGen_Walls, summary.wallCount);
+	DEC_DWORD_STAT_BY(STAT_MazeGen_WallInstances, summary.wallInstanceCount);
+	DEC_DWORD_STAT_BY(STAT_MazeGen_FloorInstances, summary.floorInstanceCount);
+	DEC_MEMORY_STAT_BY(STAT_MazeGen_GridMemory, summary.gridBytes);
+	DEC_MEMORY_STAT_BY(STAT_MazeGen_TransformMemory, summary.transformBytes);
+	DEC_MEMORY_STAT_BY(STAT_MazeGen_SolverMemory, summary.solverBytes);
+}
+
+/*===================
+FMazeGenerationSummary::ToString
+
+key=value pairs on one line, in a fixed order, so logs from two builds can be diffed or parsed
+===================*/
+FString FMazeGenerationSummary::ToString() const
+{
+	return FString::Printf(TEXT("size=%dx%d seed=%lld cached=%d async=%d cells=%d walls=%d wallInstances=%d floorInstances=%d ")
+		TEXT("gridBytes=%lld transformBytes=%lld solverBytes=%lld allocateMs=%.3f generateMs=%.3f solversMs=%.3f buildTransformsMs=%.3f ")
+		TEXT("addInstancesMs=%.3f totalMs=%.3f"),
+		width, height, seed, bFromCache ? 1 : 0, bAsync ? 1 : 0, cellCount, wallCount, wallInstanceCount, floorInstanceCount,
+		gridBytes, transformBytes, solverBytes, allocateMs, generateMs, solversMs, buildTransformsMs, addInstancesMs, totalMs);
+}
@@ -0,0 +1,56 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeInstanceBuffers
+// Purpose: Transform arrays for the floor, default wall and rotated wall instanced meshes.
+// License: MIT
+
+#include "MazeInstanceBuffers.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+/*===================
+ToTransforms
+
+Converts maze core instance placements into transforms for an instanced static mesh component,
+all with the same rotation.
+===================*/
+static void ToTransforms(const std::vector<MazeCore::FMazeInstance>& instances, const FQuat& rotation, TArray<FTransform>& outTransforms)
+{
+	outTransforms.Reset(int32(instances.size()));
+	for (const MazeCore::FMazeInstance& instance : instances) {
+		outTransforms.Emplace(rotation, FVector(instance.x, instance.y, instance.z), FVector(instance.scaleX, instance.scaleY, instance.scaleZ));
+	}
+}
+
+FTransform FMazeInstanceBuffers::ToTransform(const MazeCore::FMazeInstance& instance)
+{
+	return FTransform(FRotator::ZeroRotator, FVector(instance.x, instance.y, instance.z), FVector(instance.scaleX, instance.scaleY, instance.scaleZ));
+}
+
+void FMazeInstanceBuffers::Reset()
+{
+	floors.Reset();
+	defaultWalls.Reset();
+	rotatedWalls.Reset();
+}
+
+void FMazeInstanceBuffers::BuildFromLayout(const MazeCore::FMazeLayout& layout, float verticalWallYawDeg)
+{
+	ToTransforms(layout.floors, FQuat::Identity, floors);
+	ToTransforms(layout.horizontalWalls, FQuat::Identity, defaultWalls);
+	ToTransforms(layout.verticalWalls, FQuat(FRotator(0.0f, verticalWallYawDeg, 0.0f)), rotatedWalls);
+}
+
+void FMazeInstanceBuffers::AddTo(UInstancedStaticMeshComponent* floorComponent, UInstancedStaticMeshComponent* defaultWallComponent,
+	UInstancedStaticMeshComponent* rotatedWallComponent, bool bWorldSpace) const
+{
+	floorComponent->AddInstances(floors, false, bWorldSpace);
+	defaultWallComponent->AddInstances(defaultWalls, false, bWorldSpace);
+	rotatedWallComponent->AddInstances(rotatedWalls, false, bWorldSpace);
+}
+
+void FMazeInstanceBuffers::ClearFrom(UInstancedStaticMeshComponent* floorComponent, UInstancedStaticMeshComponent* defaultWallComponent,
+	UInstancedStaticMeshComponent* rotatedWallComponent)
+{
+	floorComponent->ClearInstances();
+	defaultWallComponent->ClearInstances();
+	rotatedWallComponent->ClearInstances();
+}
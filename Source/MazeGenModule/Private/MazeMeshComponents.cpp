@@ -0,0 +1,44 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeMeshComponents
+// Purpose: Creates the instanced mesh components used by the maze actors.
+// License: MIT
+
+#include "MazeMeshComponents.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "GameFramework/Actor.h"
+
+UInstancedStaticMeshComponent* FMazeMeshComponents::Create(AActor* owner, bool bHierarchical, const FVector& relativeLocation)
+{
+	UInstancedStaticMeshComponent* component = bHierarchical
+		? NewObject<UHierarchicalInstancedStaticMeshComponent>(owner)
+		: NewObject<UInstancedStaticMeshComponent>(owner);
+	component->SetupAttachment(owner->GetRootComponent());
+	component->SetRelativeLocation(relativeLocation);
+	component->SetMobility(EComponentMobility::Static);
+	component->RegisterComponent();
+	return component;
+}
+
+/*===================
+FMazeMeshComponents::SetHierarchical
+
+The default subobjects are created in the constructor, before any property is known, so the
+hierarchical version is swapped in at runtime. The old component and its instances are destroyed.
+===================*/
+void FMazeMeshComponents::SetHierarchical(AActor* owner, UInstancedStaticMeshComponent*& component, bool bHierarchical)
+{
+	if (component && component->IsA<UHierarchicalInstancedStaticMeshComponent>() == bHierarchical) {
+		return;
+	}
+
+	if (component) {
+		component->DestroyComponent();
+	}
+	component = Create(owner, bHierarchical);
+}
+
+void FMazeMeshComponents::SetCullDistance(UInstancedStaticMeshComponent* component, float cullDistance)
+{
+	const int32 endDistance = FMath::Max(0, FMath::RoundToInt32(cullDistance));
+	component->SetCullDistances(endDistance * 9 / 10, endDistance);
+}
@@ -8,21 +8,19 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "MazeCore/MazeCorridorGraph.h"
+#include "MazeCore/MazeGenerators.h"
+#include "MazeCore/MazeFlowField.h"
+#include "MazeCore/MazeLayout.h"
+#include "MazeCore/MazeRegionShuffle.h"
+#include "MazeCore/MazeSolver.h"
+#include "MazeCore/MazeTreeIndex.h"
+#include "MazeCore/MazeWallInstances.h"
+#include "MazeGenTypes.h"
+#include "MazeGenCache.h"
+#include "MazeInstanceBuffers.h"
 #include "ABacktrace_MazeGen.generated.h"
 
-/*NEW*/
-// Define the MazeCell struct first
-USTRUCT()
-struct FMazeCell {	
-	GENERATED_BODY()
-public:
-	bool visited = false;
-	bool northWall = true;
-	bool southWall = true;
-	bool eastWall = true;
-	bool westWall = true;
-};
-
 UCLASS()
 class MAZEGENMODULE_API AABacktrace_MazeGen : public AActor
 {
@@ -31,11 +29,179 @@ class MAZEGENMODULE_API AABacktrace_MazeGen : public AActor
 public:	
 	// Sets default values for this actor's properties
 	AABacktrace_MazeGen();
-	void GenerateMazeMeshes();
+
+	// Generates (or loads) the maze and returns the timings and sizes of the run. An async run
+	// returns the summary as it stands, and the full one is ready once OnMazeGenerated fires.
+	const FMazeGenerationSummary& GenerateMazeMeshes();
 
 	/*NEW*/
 	void VisualiseMaze();
-	void GenerateMaze(int x, int y);
+
+	// Adds prebuilt floor and wall instances, such as those from the generation cache
+	void VisualiseMaze(const FMazeInstanceBuffers& instances);
+
+	// Stops a background generation that is still running. Its result is discarded.
+	UFUNCTION(BlueprintCallable, Category = "Maze")
+	void CancelGeneration();
+
+	// True while a background generation is running
+	UFUNCTION(BlueprintPure, Category = "Maze")
+	bool IsGenerating() const { return m_cancelToken.IsValid(); }
+
+	// Stage timings, counts and memory of the last generated maze
+	UFUNCTION(BlueprintPure, Category = "Maze|Stats")
+	FMazeGenerationSummary GetGenerationSummary() const { return m_summary; }
+
+	// Cell with the entrance opening
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	FIntPoint GetStartCell() const { return FIntPoint(m_endpoints.startX, m_endpoints.startY); }
+
+	// Cell with the exit opening
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	FIntPoint GetExitCell() const { return FIntPoint(m_endpoints.exitX, m_endpoints.exitY); }
+
+	// Cell under a world location, clamped to the maze
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	FIntPoint WorldToCell(const FVector& worldLocation) const;
+
+	// World location of the centre of a cell at floor level
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	FVector CellToWorld(const FIntPoint& cell) const;
+
+	// Shortest path between two cells (A*), both included. Returns false if either cell is outside the maze.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	bool FindPath(const FIntPoint& start, const FIntPoint& goal, TArray<FIntPoint>& outPath);
+
+	// Path from a cell to the exit, read from a distance field built once per maze.
+	// Costs only the length of the path, so many agents can query it every frame.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	bool FindPathToExit(const FIntPoint& from, TArray<FIntPoint>& outPath) const;
+
+	// The solution: the path from the entrance to the exit
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	bool GetSolutionPath(TArray<FIntPoint>& outPath) const { return FindPathToExit(GetStartCell(), outPath); }
+
+	// Steps from a cell to the exit, or -1 for cells outside the maze
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	int32 GetDistanceToExit(const FIntPoint& cell) const;
+
+	// Computes the steps from a cell to every other cell. Read them with GetFieldDistance.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	bool ComputeDistanceField(const FIntPoint& from);
+
+	// Steps from the origin of the last distance field (or, without bUseCorridorGraph, the start of the
+	// last FindPath search), or -1
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	int32 GetFieldDistance(const FIntPoint& cell) const;
+
+	// Saves the maze (walls, seed, algorithm and openings) to a binary maze file.
+	// Relative paths are taken from the project directory.
+	UFUNCTION(BlueprintCallable, Category = "Maze|File")
+	bool ExportMaze(const FString& filePath) const;
+
+	// Replaces the maze with one loaded from a maze file and rebuilds the meshes from it.
+	// Returns false, keeping the current maze, if the file cannot be loaded.
+	UFUNCTION(BlueprintCallable, Category = "Maze|File")
+	bool ImportMaze(const FString& filePath);
+
+	// Steps between two cells, or -1 if either is outside the maze. Constant time with
+	// bBuildDistanceIndex, otherwise an A* search (over the corridor graph with bUseCorridorGraph).
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	int32 GetCellDistance(const FIntPoint& a, const FIntPoint& b);
+
+	// True when a cell lies on the path between two others. Constant time with bBuildDistanceIndex,
+	// otherwise an A* search (over the corridor graph with bUseCorridorGraph).
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	bool IsCellOnPath(const FIntPoint& cell, const FIntPoint& a, const FIntPoint& b);
+
+	// Adds a goal to the shared flow field. The exit is a goal after every generation.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Flow Field")
+	bool AddFlowGoal(const FIntPoint& cell);
+
+	// Removes a goal from the shared flow field
+	UFUNCTION(BlueprintCallable, Category = "Maze|Flow Field")
+	bool RemoveFlowGoal(const FIntPoint& cell);
+
+	// Makes the exit the only flow field goal again
+	UFUNCTION(BlueprintCallable, Category = "Maze|Flow Field")
+	void ResetFlowGoals();
+
+	// Neighbouring cell offset that leads towards the nearest goal, (0, 0) at a goal or when none can be reached
+	UFUNCTION(BlueprintPure, Category = "Maze|Flow Field")
+	FIntPoint GetFlowStep(const FIntPoint& cell) const;
+
+	// Steps from a cell to the nearest goal, or -1
+	UFUNCTION(BlueprintPure, Category = "Maze|Flow Field")
+	int32 GetFlowDistance(const FIntPoint& cell) const;
+
+	// Unit world direction an agent at a location should steer in: towards the centre of the next
+	// cell on the way to the nearest goal. Zero when no goal can be reached.
+	UFUNCTION(BlueprintPure, Category = "Maze|Flow Field")
+	FVector GetFlowDirectionAtLocation(const FVector& worldLocation) const;
+
+	// True when the given side of a cell is closed
+	UFUNCTION(BlueprintPure, Category = "Maze|Walls")
+	bool HasWall(const FIntPoint& cell, EMazeWallSide side) const;
+
+	// Opens or closes one wall at runtime (needs bEnableWallEdits). Only the wall instances it touches
+	// change, and every edit of a frame reaches the mesh components in one flush at the end of the frame.
+	// Returns false if the wall already was that way.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Walls")
+	bool SetWall(const FIntPoint& cell, EMazeWallSide side, bool bClosed);
+
+	UFUNCTION(BlueprintCallable, Category = "Maze|Walls")
+	bool ToggleWall(const FIntPoint& cell, EMazeWallSide side) { return SetWall(cell, side, !HasWall(cell, side)); }
+
+	// Opens the single wall edge at a point on a wall's surface, such as a hit location and normal.
+	// Only that edge opens, even when the wall was merged into a longer instance.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Walls")
+	bool RemoveWallAtLocation(const FVector& worldLocation, const FVector& worldNormal);
+
+	// Applies pending wall edits to the mesh components now rather than at the end of the frame
+	UFUNCTION(BlueprintCallable, Category = "Maze|Walls")
+	void FlushWallEdits();
+
+	// Rebuilds the exit distance field, the flow field (keeping its goals) and the distance index
+	// after walls were edited
+	UFUNCTION(BlueprintCallable, Category = "Maze|Solver")
+	void RefreshSolvers();
+
+	// True when walls changed since the solvers were last refreshed, so their answers describe the old walls
+	UFUNCTION(BlueprintPure, Category = "Maze|Solver")
+	bool AreSolversOutdated() const { return m_bSolversOutdated; }
+
+	// Re-randomises a rectangle of the maze while it is played (needs bEnableWallEdits). The maze stays
+	// perfect: the region gets a new maze and one opening into each part of the maze around it. The work
+	// is spread over frames within shiftBudgetMs and only the wall instances that change are updated.
+	// Returns false if a shift is already running or the rectangle misses the maze.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Shifting")
+	bool ShiftRegion(const FIntPoint& minCell, const FIntPoint& size);
+
+	// Shifts a region of shiftRegionSize at a random position
+	UFUNCTION(BlueprintCallable, Category = "Maze|Shifting")
+	bool ShiftRandomRegion();
+
+	// True from ShiftRegion until the region's wall instances are updated
+	UFUNCTION(BlueprintPure, Category = "Maze|Shifting")
+	bool IsShifting() const { return m_regionShuffle.IsRunning() || m_regionShuffle.IsDone(); }
+
+	// Abandons a shift that has not changed the grid yet. Once its region is in the grid, a shift only
+	// has instance updates left and runs to the end.
+	UFUNCTION(BlueprintCallable, Category = "Maze|Shifting")
+	void CancelShift();
+
+	// Broadcast once the maze instances have been added
+	UPROPERTY(BlueprintAssignable, Category = "Maze Events")
+	FOnMazeGenerated OnMazeGenerated;
+
+	// Broadcast when a shift has finished. The solvers still describe the old walls; call RefreshSolvers
+	// here if their answers are needed.
+	UPROPERTY(BlueprintAssignable, Category = "Maze Events")
+	FOnMazeRegionShifted OnRegionShifted;
+
+	// Algorithm used to carve the maze. The recursive version overflows the stack on large mazes.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
+	EMazeAlgorithm algorithm = EMazeAlgorithm::IterativeBacktracker;
 
 	// Width of the maze in grid cells 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
@@ -45,6 +211,74 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
 	int levelHeight = 128;
 
+	// Seed for the maze generator. The same seed always produces the same maze on every platform.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	int64 seed = 0;
+
+	// Pick a new seed each time the maze is generated. The chosen seed is written back to 'seed'.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bRandomizeSeed = true;
+
+	// Generate the grid and build the instance transforms on a background thread.
+	// Only adding the instances to the meshes runs on the game thread.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bGenerateAsync = false;
+
+	// Load this maze file on BeginPlay instead of generating a maze (see ExportMaze). Files that are
+	// not packed into a pak file are memory-mapped, so even very large mazes load in milliseconds.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings", meta = (FilePathFilter = "Maze files (*.maze)|*.maze", RelativeToGameDir))
+	FFilePath mazeFile;
+
+	// Build a tree index after generation so cell to cell distance and on-path queries take constant
+	// time. Costs about 8 bytes per cell and only works on mazes without loops, which all generators produce.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bBuildDistanceIndex = false;
+
+	// Build a corridor graph after generation, and run FindPath, distance fields and the searches behind
+	// GetCellDistance and IsCellOnPath over its junctions instead of over every cell. Costs 8 bytes per
+	// cell plus the nodes and corridors. The exit distance field and the multi-goal flow field still
+	// cover every cell. While AreSolversOutdated the queries search every cell instead, until RefreshSolvers
+	// rebuilds the graph.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bUseCorridorGraph = false;
+
+	// Keep the grid and instance transforms of every generated maze in the generation cache (memory
+	// and Saved/MazeCache), and reuse them when the same settings come round again. Only applies with
+	// a fixed seed, as a randomized seed never repeats. Log the hit rate with MazeGen.Cache.Stats.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bUseGenerationCache = true;
+
+	// Allow walls to be opened and closed at runtime (SetWall, RemoveWallAtLocation). Keeps a map from
+	// every cell edge to its wall instance, about 8 bytes per cell, and makes the wall meshes movable.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bEnableWallEdits = false;
+
+	// Refresh the solvers once per frame in which walls were edited. Costs a breadth-first search over the
+	// whole maze (tens of milliseconds at 1024 x 1024), so it is off by default: call RefreshSolvers when
+	// AreSolversOutdated and the answers are needed. Only turn it on for small mazes. Shifts never refresh
+	// the solvers themselves.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bRefreshSolversOnWallEdit = false;
+
+	// Moving labyrinth: shift a random region every shiftInterval seconds (needs bEnableWallEdits)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Shifting")
+	bool bAutoShift = false;
+
+	// Seconds between automatic shifts, counted from the end of the last one
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Shifting", meta = (ClampMin = "0"))
+	float shiftInterval = 5.0f;
+
+	// Size in cells of the regions ShiftRandomRegion picks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Shifting")
+	FIntPoint shiftRegionSize = FIntPoint(16, 16);
+
+	// Game thread time a running shift may use per frame, in milliseconds. Finding the parts of the maze
+	// around the region reads every cell once (around 100 ms of work on a 2048 x 2048 maze), so a shift
+	// takes more frames the larger the maze. The new region is written a few rows at a time, so a large
+	// region also spreads over frames.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Shifting", meta = (ClampMin = "0.1"))
+	float shiftBudgetMs = 1.0f;
+
 	// Distance between cells (affects positioning) 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
 	int positionScaling = 200;
@@ -62,6 +296,23 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh ZOffset")
 	float zOffset = 0.1f;
 
+	// Merge consecutive walls along a line into one stretched instance (far fewer instances)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	bool bMergeWalls = true;
+
+	// One floor slab for the whole maze, or one floor per cell
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	EMazeFloorMode floorMode = EMazeFloorMode::SingleSlab;
+
+	// Use hierarchical instanced meshes, which cull and choose LODs per spatial cluster of instances
+	// instead of for the whole maze. Worth it for mazes much larger than the view.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	bool bUseHierarchicalInstancing = false;
+
+	// Instances further than this from the camera are culled (0 never culls)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings", meta = (ClampMin = "0"))
+	float instanceCullDistance = 0.0f;
+
 	// Static mesh for the floor 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Settings")
 	UStaticMesh* floorStaticMesh;
@@ -86,6 +337,68 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Cancels any background generation
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Assigns meshes and materials. Returns false if a component is missing.
+	bool SetupMeshComponents();
+
+	// Runs generation and transform building on a worker thread
+	void GenerateMazeMeshesAsync();
+
+	// Copies the layout related settings into the maze core struct
+	MazeCore::FMazeLayoutSettings GetLayoutSettings() const;
+
+	// Sizes the solvers for a freshly generated grid, builds the distance field and flow field to the exit,
+	// and the tree index and corridor graph when they are enabled
+	void InitSolvers();
+
+	// Points the solvers at the actor's grid after they were built on another copy of it
+	void RebindSolvers();
+
+	// Builds the edge to instance maps for the walls just added, when bEnableWallEdits is set
+	void InitWallEdits();
+
+	// Starts a new summary for the current settings, taking the last maze out of the stats
+	void BeginSummary(bool bAsync);
+
+	// Fills in the counts and memory of the maze now shown, adds it to the stats and logs it
+	void FinishSummary(const FMazeInstanceBuffers& instances);
+
+	// Runs the current shift for up to shiftBudgetMs, then brings the wall runs in step with it
+	void AdvanceShift();
+
+	// Ticks while edits wait to be flushed, a shift is running, or shifts are automatic
+	void UpdateTickEnabled();
+
+	// True for cells inside the generated grid
+	bool IsValidCell(const FIntPoint& cell) const;
+
+	// True when the corridor graph is built and describes the current walls
+	bool CanUseCorridorGraph() const;
+
+	// Shortest path between two valid cells into m_pathCells, over the corridor graph when it is current.
+	// Returns the steps, or -1.
+	int32 SearchPath(const FIntPoint& start, const FIntPoint& goal);
+
+	// Thread-safe: generates a maze exactly as MazeCore::GenerateMazeFromSeed does, timing each stage
+	static MazeCore::FMazeEndpoints GenerateGrid(MazeCore::FMazeGrid& mazeGrid, int32 width, int32 height, MazeCore::EMazeGenAlgorithm mazeAlgorithm,
+		uint64 mazeSeed, FMazeGenerationSummary& summary, const MazeCore::FMazeCancelFlag* cancel = nullptr);
+
+	// Thread-safe: builds the floor and wall transforms for a grid
+	static void BuildInstanceBuffers(const MazeCore::FMazeGrid& mazeGrid, const MazeCore::FMazeLayoutSettings& settings, FMazeInstanceBuffers& outBuffers,
+		FMazeGenerationSummary& summary);
+
+	// Thread-safe: everything InitSolvers builds, for a grid that is not the actor's yet
+	static void BuildSolvers(const MazeCore::FMazeGrid& mazeGrid, const MazeCore::FMazeEndpoints& endpoints, bool bBuildIndex, bool bBuildGraph,
+		MazeCore::FMazeSolver& outSolver, MazeCore::FMazeSolver& outExitSolver, MazeCore::FMazeFlowField& outFlowField, MazeCore::FMazeTreeIndex& outTreeIndex,
+		MazeCore::FMazeCorridorGraph& outCorridorGraph, FMazeGenerationSummary& summary);
+
+	// Thread-safe: returns the cached maze for a key, generating it and building its transforms on a miss.
+	// Returns null if cancelled.
+	static FMazeGenCacheEntryPtr FindOrGenerateMaze(const FMazeGenCacheKey& key, const MazeCore::FMazeLayoutSettings& settings,
+		FMazeGenerationSummary& summary, const MazeCore::FMazeCancelFlag* cancel = nullptr);
+
 	// Instanced Static Mesh for default walls (not exposed to editor)
 	UPROPERTY()
 	UInstancedStaticMeshComponent* m_defaultWallStaticMeshComponent;
@@ -111,8 +424,56 @@ protected:
 	UMaterialInstanceDynamic* m_floorInstancedMaterial;
 
 	/*NEW*/
-	// Double Dynamic Array to hold our struct
-	TArray<TArray<FMazeCell>> grid;
+	// Flat bit-packed grid holding the walls of every cell
+	MazeCore::FMazeGrid grid;
+
+	// Entrance and exit of the current grid
+	MazeCore::FMazeEndpoints m_endpoints;
+
+	// Distance field to the exit, built once per maze, and a solver for any other query
+	MazeCore::FMazeSolver m_exitSolver;
+	MazeCore::FMazeSolver m_solver;
+
+	// Direction to the nearest goal for every cell, shared by all agents
+	MazeCore::FMazeFlowField m_flowField;
+
+	// Cell to cell distances, built when bBuildDistanceIndex is set
+	MazeCore::FMazeTreeIndex m_treeIndex;
+
+	// Junctions and corridors of the grid, built when bUseCorridorGraph is set
+	MazeCore::FMazeCorridorGraph m_corridorGraph;
+
+	// The last ComputeDistanceField ran on the corridor graph rather than m_solver
+	bool m_bFieldOnGraph = false;
+
+	// Wall runs of the default (horizontal) and rotated (vertical) wall components, kept in step with
+	// wall edits. Empty unless bEnableWallEdits is set.
+	MazeCore::FMazeWallInstances m_horizontalWalls;
+	MazeCore::FMazeWallInstances m_verticalWalls;
+
+	// Grid changed since the solvers were last refreshed, and whether SetWall changed it (shifts do not
+	// refresh the solvers on their own)
+	bool m_bSolversOutdated = false;
+	bool m_bWallsEdited = false;
+
+	// The running shift, the next of its changed walls to pass on to the wall runs, and the stream
+	// the shift seeds and random regions are drawn from (seeded from the maze seed)
+	MazeCore::FMazeRegionShuffle m_regionShuffle;
+	int32 m_nextShiftedWall = 0;
+	MazeCore::FMazeRandom m_shiftRandom;
+
+	// Seconds since the last automatic shift finished
+	float m_shiftTimer = 0.0f;
+
+	// Cell indices of the last path, reused between queries
+	mutable std::vector<int32_t> m_pathCells;
+
+	// The last generated maze, counted in the MazeGen stats while cellCount is set
+	FMazeGenerationSummary m_summary;
+	double m_summaryStartTime = 0.0;
+
+	// Set to cancel the running background generation (null when none is running)
+	TSharedPtr<MazeCore::FMazeCancelFlag, ESPMode::ThreadSafe> m_cancelToken;
 
 public:	
 	// Called every frame
@@ -0,0 +1,151 @@
+// Author: Joshua Hall - Griffith University
+// Class: AAChunked_MazeGen
+// Purpose: This class streams an effectively infinite maze around the player in fixed-size chunks.
+// Each chunk is generated from (seed, chunkX, chunkY) alone, with matching openings across chunk borders,
+// and gets its own instanced static meshes so it can be unloaded again. Memory and instance count
+// depend on the load radius, not on the size of the maze.
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "MazeGenTypes.h"
+#include "AChunked_MazeGen.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+// Mesh components of one loaded chunk
+USTRUCT()
+struct FMazeChunkComponents
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* floor = nullptr;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* defaultWalls = nullptr;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* rotatedWalls = nullptr;
+};
+
+UCLASS()
+class MAZEGENMODULE_API AAChunked_MazeGen : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AAChunked_MazeGen();
+
+	// Loads chunks within loadRadius of the location and unloads the ones that fell out of range
+	void UpdateStreaming(const FVector& viewLocation);
+
+	// Number of chunks currently loaded
+	UFUNCTION(BlueprintPure, Category = "Maze")
+	int32 GetLoadedChunkCount() const { return m_loadedChunks.Num(); }
+
+	// Width and height of a chunk in grid cells
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings", meta = (ClampMin = "2"))
+	int chunkSize = 64;
+
+	// Chunks within this many chunks of the player are loaded (a square of 2 * loadRadius + 1 chunks)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings", meta = (ClampMin = "0"))
+	int loadRadius = 2;
+
+	// Upper bound on chunks built in one frame, to keep streaming free of hitches
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings", meta = (ClampMin = "1"))
+	int maxChunkLoadsPerFrame = 1;
+
+	// Seed for the maze generator. The same seed always produces the same maze on every platform.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	int64 seed = 0;
+
+	// Pick a new seed when play begins. The chosen seed is written back to 'seed'.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bRandomizeSeed = true;
+
+	// Distance between cells (affects positioning) 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
+	int positionScaling = 200;
+
+	// Scaling factor for wall and floor meshes 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
+	FVector meshScaling = FVector{ 1.0f, 1.0f, 1.0f };
+
+	// Small offset value to add to remove z fighting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh ZOffset")
+	float zOffset = 0.1f;
+
+	// Merge consecutive walls along a line into one stretched instance (far fewer instances)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	bool bMergeWalls = true;
+
+	// One floor slab per chunk, or one floor per cell
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	EMazeFloorMode floorMode = EMazeFloorMode::SingleSlab;
+
+	// Use hierarchical instanced meshes, which cull and choose LODs per spatial cluster of instances
+	// instead of for the whole maze. Worth it for mazes much larger than the view.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	bool bUseHierarchicalInstancing = false;
+
+	// Instances further than this from the camera are culled (0 never culls)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings", meta = (ClampMin = "0"))
+	float instanceCullDistance = 0.0f;
+
+	// Static mesh for the floor 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Settings")
+	UStaticMesh* floorStaticMesh;
+
+	// Static mesh for the walls 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Settings")
+	UStaticMesh* wallStaticMesh;
+
+	// Default material for walls 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Settings")
+	UMaterial* defaultWallMaterial;
+
+	// Material for rotated walls 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Settings")
+	UMaterial* rotatedWallMaterial;
+
+	// Material for the floor 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Settings")
+	UMaterial* floorMaterial;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	// Generates a chunk and creates its mesh components
+	void LoadChunk(const FIntPoint& chunk);
+
+	// Destroys the mesh components of a chunk
+	void UnloadChunk(const FIntPoint& chunk);
+
+	// Creates and registers an instanced mesh component positioned at the chunk origin
+	UInstancedStaticMeshComponent* CreateChunkComponent(UStaticMesh* mesh, UMaterialInterface* material, const FVector& chunkOrigin);
+
+	// Loaded chunks by chunk coordinate
+	UPROPERTY()
+	TMap<FIntPoint, FMazeChunkComponents> m_loadedChunks;
+
+	// Dynamic material instance for rotated walls 
+	UPROPERTY()
+	UMaterialInstanceDynamic* m_rotatedWallInstancedMaterial;
+
+	// Dynamic material instance for default walls 
+	UPROPERTY()
+	UMaterialInstanceDynamic* m_defaultWallInstancedMaterial;
+
+	// Dynamic material instance for the floor 
+	UPROPERTY()
+	UMaterialInstanceDynamic* m_floorInstancedMaterial;
+
+public:	
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+};
@@ -8,8 +8,12 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "MazeCore/MazeGenerators.h"
+#include "MazeGenTypes.h"
 #include "ATurn_MazeGen.generated.h"
 
+struct FMazeInstanceBuffers;
+
 UCLASS()
 class MAZEGENMODULE_API AATurn_MazeGen : public AActor
 {
@@ -18,7 +22,26 @@ class MAZEGENMODULE_API AATurn_MazeGen : public AActor
 public:	
 	// Sets default values for this actor's properties
 	AATurn_MazeGen();
-	void GenerateMazeMeshes();
+
+	// Generates the maze and returns the timings and sizes of the run. An async run returns the
+	// summary as it stands, and the full one is ready once OnMazeGenerated fires.
+	const FMazeGenerationSummary& GenerateMazeMeshes();
+
+	// Stops a background generation that is still running. Its result is discarded.
+	UFUNCTION(BlueprintCallable, Category = "Maze")
+	void CancelGeneration();
+
+	// True while a background generation is running
+	UFUNCTION(BlueprintPure, Category = "Maze")
+	bool IsGenerating() const { return m_cancelToken.IsValid(); }
+
+	// Stage timings, counts and memory of the last generated maze
+	UFUNCTION(BlueprintPure, Category = "Maze|Stats")
+	FMazeGenerationSummary GetGenerationSummary() const { return m_summary; }
+
+	// Broadcast once the maze instances have been added
+	UPROPERTY(BlueprintAssignable, Category = "Maze Events")
+	FOnMazeGenerated OnMazeGenerated;
 
 	// Width of the maze in grid cells 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
@@ -28,6 +51,25 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
 	int levelHeight = 128;
 
+	// Seed for the maze generator. The same seed always produces the same maze on every platform.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	int64 seed = 0;
+
+	// Pick a new seed each time the maze is generated. The chosen seed is written back to 'seed'.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bRandomizeSeed = true;
+
+	// Choose the walls and build the instance transforms on a background thread.
+	// Only adding the instances to the meshes runs on the game thread.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bGenerateAsync = false;
+
+	// Keep the instance transforms of every generated maze in the generation cache (memory and
+	// Saved/MazeCache), and reuse them when the same settings come round again. Only applies with
+	// a fixed seed, as a randomized seed never repeats.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Settings")
+	bool bUseGenerationCache = true;
+
 	// Distance between cells (affects positioning) 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Maze Settings")
 	int positionScaling = 200;
@@ -41,6 +83,19 @@ public:
 	FVector meshScaling = FVector{ 1.0f, 1.0f, 1.0f };
 
 
+	// One floor slab for the whole maze, or one floor per cell
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	EMazeFloorMode floorMode = EMazeFloorMode::SingleSlab;
+
+	// Use hierarchical instanced meshes, which cull and choose LODs per spatial cluster of instances
+	// instead of for the whole maze. Worth it for mazes much larger than the view.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings")
+	bool bUseHierarchicalInstancing = false;
+
+	// Instances further than this from the camera are culled (0 never culls)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Settings", meta = (ClampMin = "0"))
+	float instanceCullDistance = 0.0f;
+
 	// Static mesh for the floor 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Settings")
 	UStaticMesh* floorStaticMesh;
@@ -65,6 +120,18 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Cancels any background generation
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Runs wall selection and transform building on a worker thread
+	void GenerateMazeMeshesAsync();
+
+	// Starts a new summary for the current settings, taking the last maze out of the stats
+	void BeginSummary(bool bAsync);
+
+	// Fills in the counts and memory of the maze now shown, adds it to the stats and logs it
+	void FinishSummary(const FMazeInstanceBuffers& instances);
+
 	// Instanced Static Mesh for default walls (not exposed to editor)
 	UPROPERTY()
 	UInstancedStaticMeshComponent* m_defaultWallStaticMeshComponent;
@@ -89,6 +156,13 @@ protected:
 	UPROPERTY()
 	UMaterialInstanceDynamic* m_floorInstancedMaterial;
 
+	// Set to cancel the running background generation (null when none is running)
+	TSharedPtr<MazeCore::FMazeCancelFlag, ESPMode::ThreadSafe> m_cancelToken;
+
+	// The last generated maze, counted in the MazeGen stats while cellCount is set
+	FMazeGenerationSummary m_summary;
+	double m_summaryStartTime = 0.0;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
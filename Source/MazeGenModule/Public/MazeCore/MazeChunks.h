@@ -0,0 +1,20 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Deterministic chunks of an unbounded maze.
+// Each chunk is a square perfect maze generated from (seed, chunkX, chunkY) alone. The border
+// between two neighbouring chunks has one opening whose position both chunks derive from the
+// same hash, so any chunk can be generated on its own and still line up with its neighbours.
+// Every chunk is reachable from every other one; loops only exist at the scale of whole chunks.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	// Position of the opening along the west (bWestBorder) or south border of a chunk
+	int32_t GetChunkBorderOpening(uint64_t seed, int32_t chunkX, int32_t chunkY, bool bWestBorder, int32_t chunkSize);
+
+	// Generates chunk (chunkX, chunkY) into a chunkSize x chunkSize grid, including the openings on all four borders
+	void GenerateMazeChunk(FMazeGrid& grid, uint64_t seed, int32_t chunkX, int32_t chunkY, int32_t chunkSize);
+}
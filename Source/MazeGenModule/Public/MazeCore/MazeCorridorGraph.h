@@ -0,0 +1,176 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeCorridorGraph
+// Purpose: A maze grid compressed to its junctions and dead ends.
+// Most cells of a generated maze have exactly two open walls and only lead from one cell to the next.
+// The graph keeps every other cell as a node and every corridor between two nodes as one edge
+// weighted by its length, and remembers which edge, and how far along it, each corridor cell lies.
+// Searches then only visit nodes, and any cell can still be used as a start, a goal or a query.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	class FMazeCorridorGraph
+	{
+	public:
+		// Builds the graph by walking every corridor of the grid once. Call again whenever the grid changes.
+		void Build(const FMazeGrid& grid);
+
+		// Walks the corridors of another grid with the same walls, such as the one it was built from once
+		// that has been moved. Does not rebuild anything.
+		void Rebind(const FMazeGrid& grid) { m_grid = &grid; }
+
+		int32_t GetNodeCount() const { return int32_t(m_nodeCells.size()); }
+		int32_t GetEdgeCount() const { return int32_t(m_edges.size()); }
+
+		// True when a path joins the two cells
+		bool IsReachable(int32_t startX, int32_t startY, int32_t goalX, int32_t goalY) const;
+
+		// A* over the nodes with a Manhattan heuristic. Writes the packed cell indices from start to goal
+		// (both included) and returns the number of steps, or -1 if the goal cannot be reached.
+		int32_t FindPath(int32_t startX, int32_t startY, int32_t goalX, int32_t goalY, std::vector<int32_t>& outPath);
+
+		// Distances from a cell to every node it can reach. Read any cell's distance with GetDistance,
+		// and follow GetStepToFieldSource from any cell to walk back to the source, until the next query.
+		void ComputeDistanceField(int32_t x, int32_t y);
+
+		// Steps from the last distance field's source to a cell, or -1 if the cell was not reached
+		int32_t GetDistance(int32_t x, int32_t y) const;
+
+		// Packed index of the neighbouring cell one step closer to the last distance field's source,
+		// or -1 at the source itself or when the source cannot be reached
+		int32_t GetStepToFieldSource(int32_t x, int32_t y) const;
+
+		size_t GetAllocatedSize() const;
+
+	private:
+		// A corridor between two nodes. Corridor cells are numbered by their distance from nodeA, so
+		// nodeA sits at offset 0 and nodeB at offset length. A corridor in a loop can start and end on
+		// the same node.
+		struct FEdge
+		{
+			int32_t nodeA;
+			int32_t nodeB;
+			int32_t length;
+
+			// The cells next to nodeA and next to nodeB (the other node when the corridor is one step long)
+			int32_t firstCell;
+			int32_t lastCell;
+		};
+
+		// Where a cell lies: on a node, or on an edge at an offset from its nodeA
+		struct FLocation
+		{
+			int32_t node;
+			int32_t edge;
+			int32_t offset;
+		};
+
+		// One edge as seen from a node: the node at its far end, its length, and the parent code the
+		// far node gets when a search reaches it this way. Parent codes are (edge << 1 | 1 when the
+		// node was reached at the edge's nodeB end), -1 for a start at nodeA or on a node, and -2 for
+		// a start at nodeB.
+		struct FLink
+		{
+			int32_t node;
+			int32_t length;
+			int32_t parent;
+		};
+
+		// Per cell entries of m_cellEdge that are not edge ids
+		static constexpr int32_t Unassigned = INT32_MIN;
+		static int32_t EncodeNode(int32_t node) { return -node - 1; }
+		static int32_t DecodeNode(int32_t code) { return -code - 1; }
+
+		// Every node has at most four edges, one per open wall
+		static constexpr int32_t MaxNodeLinks = 4;
+
+		static constexpr int32_t Unreached = INT32_MAX;
+
+		int32_t GetOrAddNode(int32_t cell);
+		void AddLink(int32_t node, const FLink& link);
+		const FLink* GetLinks(int32_t node) const { return &m_links[size_t(node) * MaxNodeLinks]; }
+
+		// Dead ends have a single edge, so a search never has to expand one it did not start from
+		bool IsDeadEnd(int32_t node) const { return GetLinks(node)[1].node < 0; }
+
+		// Follows the corridor that leaves a node through one of its open walls and adds it as an edge
+		void WalkCorridor(int32_t node, int32_t firstCell);
+
+		// Labels the connected component of every node
+		void BuildComponents();
+
+		FLocation Locate(int32_t cell) const;
+		int32_t GetComponent(const FLocation& location) const;
+
+		// Neighbouring cell one step from a cell along its edge, towards nodeB when direction is 1
+		// and towards nodeA when it is -1. Returns -1 if a wall along the corridor was closed since Build.
+		int32_t StepAlongEdge(const FEdge& edge, int32_t cell, int32_t offset, int32_t direction) const;
+
+		// Appends the cells from fromOffset (exclusive) to toOffset (inclusive) along the edge,
+		// starting from the cell at the back of the path. Returns false if the corridor is no longer open.
+		bool AppendEdgeCells(int32_t edgeIndex, int32_t fromOffset, int32_t toOffset, std::vector<int32_t>& outPath) const;
+
+		// Starts a new search; every stamp from earlier searches becomes stale
+		void BeginQuery();
+		bool IsCurrent(int32_t node) const { return m_stamp[node] == m_epoch; }
+
+		void Visit(int32_t node, int32_t distance, int32_t parent)
+		{
+			m_stamp[node] = m_epoch;
+			m_distance[node] = distance;
+			m_parent[node] = parent;
+		}
+
+		// Distance from the search's start to the goal through a node that was just reached at the
+		// given distance, or Unreached if the node is neither the goal nor an end of its corridor.
+		// outOffset is the node's offset along the goal's corridor.
+		int32_t GetGoalDistance(int32_t node, int32_t distance, const FLocation& goal, int32_t& outOffset) const;
+
+		// Manhattan distance from a node to a cell
+		int32_t GetHeuristic(int32_t node, int32_t goalCell) const;
+
+		// Path searches. On a forest the first path found to any node is its only one, so the search
+		// heads greedily towards the goal and stops as soon as it reaches it. Graphs with loops run A*.
+		// Both write the goal distance and the node the goal was reached through.
+		void SearchForest(const FLocation& start, const FLocation& goal, int32_t goalCell, int32_t& inOutBest, int32_t& outNode, int32_t& outOffset);
+		void SearchGraph(const FLocation& start, const FLocation& goal, int32_t goalCell, int32_t& inOutBest, int32_t& outNode, int32_t& outOffset);
+
+		int32_t GetCellDistance(int32_t cell) const;
+
+		const FMazeGrid* m_grid = nullptr;
+
+		// Per cell: an edge id, or an encoded node id
+		std::vector<int32_t> m_cellEdge;
+
+		// Per corridor cell: distance from its edge's nodeA
+		std::vector<int32_t> m_cellOffset;
+
+		// Per node: its cell, its links (node -1 for unused slots) and its connected component
+		std::vector<int32_t> m_nodeCells;
+		std::vector<FLink> m_links;
+		std::vector<int32_t> m_nodeComponents;
+
+		std::vector<FEdge> m_edges;
+
+		// True when the graph has no loops, which holds for every maze GenerateMaze produces
+		bool m_bForest = true;
+
+		// Search state per node, stamped with the query epoch like FMazeSolver
+		uint32_t m_epoch = 0;
+		std::vector<uint32_t> m_stamp;
+		std::vector<int32_t> m_distance;
+		std::vector<int32_t> m_parent;
+
+		// Nodes still to expand: a stack for distance fields on a forest, otherwise a binary heap of
+		// (key << 32 | node)
+		std::vector<int32_t> m_stack;
+		std::vector<uint64_t> m_openHeap;
+
+		// Location of the last distance field's source
+		FLocation m_fieldSource = { -1, -1, 0 };
+	};
+}
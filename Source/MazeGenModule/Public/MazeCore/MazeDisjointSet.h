@@ -0,0 +1,88 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeDisjointSet
+// Purpose: Union-find over packed cell indices, stored as one flat array.
+// Path halving and union by rank keep every operation close to constant time.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MazeCore
+{
+	class FMazeDisjointSet
+	{
+	public:
+		// Puts each of the count elements in a set of its own
+		void Init(int32_t count)
+		{
+			m_parent.assign(size_t(count), -1);
+		}
+
+		// Empties the set and allocates room for count elements. The memory is not written, so a
+		// large reservation costs little until Add reaches it.
+		void Reserve(int32_t count)
+		{
+			m_parent.clear();
+			m_parent.reserve(size_t(count));
+		}
+
+		// Removes every element, keeping the allocation
+		void Clear()
+		{
+			m_parent.clear();
+		}
+
+		// Adds an element in a set of its own and returns it
+		int32_t Add()
+		{
+			m_parent.push_back(-1);
+			return int32_t(m_parent.size()) - 1;
+		}
+
+		int32_t Find(int32_t element)
+		{
+			while (m_parent[element] >= 0)
+			{
+				const int32_t parent = m_parent[element];
+				if (m_parent[parent] < 0) {
+					return parent;
+				}
+				m_parent[element] = m_parent[parent];
+				element = m_parent[parent];
+			}
+			return element;
+		}
+
+		// Merges the sets of a and b. Returns false if they were already the same set.
+		bool Union(int32_t a, int32_t b)
+		{
+			a = Find(a);
+			b = Find(b);
+			if (a == b) {
+				return false;
+			}
+
+			// Roots hold -1 - rank, so the lower value has the higher rank
+			if (m_parent[a] > m_parent[b]) {
+				m_parent[a] = b;
+			}
+			else {
+				if (m_parent[a] == m_parent[b]) {
+					m_parent[a]--;
+				}
+				m_parent[b] = a;
+			}
+			return true;
+		}
+
+		size_t GetAllocatedSize() const { return m_parent.capacity() * sizeof(int32_t); }
+
+	private:
+		// Parent of each element, or -1 - rank for the root of a set. Keeping the rank in the
+		// root's slot means a lookup touches one array, which matters once it outgrows the cache.
+		std::vector<int32_t> m_parent;
+	};
+}
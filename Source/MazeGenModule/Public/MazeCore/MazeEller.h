@@ -0,0 +1,75 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeRowWalls, FMazeEllerGenerator
+// Purpose: Eller's algorithm, which builds a perfect maze one row at a time.
+// Only the current row's set membership is kept (O(width) memory), and each finished row is handed
+// to the caller, who can write it into a grid, a file or a mesh builder. Rows can be pulled forever
+// for an endless maze; the last row of a finite maze joins every remaining set so it stays perfect.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGenerators.h"
+
+#include <functional>
+
+namespace MazeCore
+{
+	// Walls of one finished row. Uses the same conventions as FMazeGrid.
+	struct FMazeRowWalls
+	{
+		int32_t y = 0;
+
+		// width + 1 bits: bit x is the wall on the west side of cell x, bit width is the east border
+		std::vector<uint64_t> westWalls;
+
+		// width bits: bit x is the wall on the north side of cell x
+		std::vector<uint64_t> northWalls;
+
+		bool HasWestWall(int32_t x) const { return (westWalls[x >> 6] >> (x & 63)) & 1; }
+		bool HasEastWall(int32_t x) const { return HasWestWall(x + 1); }
+		bool HasNorthWall(int32_t x) const { return (northWalls[x >> 6] >> (x & 63)) & 1; }
+	};
+
+	class FMazeEllerGenerator
+	{
+	public:
+		// Starts a new maze of the given width. The first row's south side is the maze border.
+		void Init(int32_t width, uint64_t seed);
+
+		// Carves the next row. For the last row of a finite maze pass bLastRow, which joins every
+		// remaining set and closes the north border. The result is valid until the next call.
+		const FMazeRowWalls& NextRow(bool bLastRow);
+
+		int32_t GetWidth() const { return m_width; }
+
+		// Index of the next row to be carved
+		int32_t GetNextRowIndex() const { return m_nextRow; }
+
+		// Bytes held by the generator. Depends only on the width.
+		size_t GetAllocatedSize() const;
+
+	private:
+		int32_t FindSet(int32_t set);
+
+		int32_t m_width = 0;
+		int32_t m_nextRow = 0;
+		FMazeRandom m_random;
+		FMazeRowWalls m_row;
+
+		// Set of every cell in the current row. Set ids are in [0, width).
+		std::vector<int32_t> m_cellSets;
+
+		// Per set scratch: union-find parent, cell count, chosen cell and a flag
+		std::vector<int32_t> m_setParent;
+		std::vector<int32_t> m_setCellCount;
+		std::vector<int32_t> m_setChosenCell;
+		std::vector<uint8_t> m_setFlag;
+	};
+
+	// Streams a width x height maze row by row, bottom row first, to the consumer
+	void GenerateEllerMaze(int32_t width, int32_t height, uint64_t seed, const std::function<void(const FMazeRowWalls&)>& consumer,
+		const FMazeCancelFlag* cancel = nullptr);
+
+	// Copies the walls of a row into row.y of a grid with the same width
+	void ApplyMazeRow(FMazeGrid& grid, const FMazeRowWalls& row);
+}
@@ -0,0 +1,86 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeFileHeader
+// Purpose: Binary maze file format. A 64 byte header followed by the two wall planes exactly as FMazeGrid
+// holds them in memory, so loading is a bounds check and a copy with no parsing, straight from a memory
+// mapped file. The planes are split into sections of whole rows, each holding its rows of the south wall
+// plane followed by the same rows of the west wall plane. A section's offset follows from its index, so
+// a streaming loader can copy in one section at a time. All values are little-endian.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGenerators.h"
+
+#include <functional>
+
+namespace MazeCore
+{
+	// "MZG1" in file byte order
+	constexpr uint32_t MazeFileMagic = 0x31475A4D;
+	constexpr uint32_t MazeFileVersion = 1;
+
+	// 256 rows of a 16384 wide maze make 2 MB sections
+	constexpr int32_t DefaultMazeFileSectionRows = 256;
+
+	struct FMazeFileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		int32_t width;
+		int32_t height;
+		uint64_t seed;
+		uint32_t algorithm;
+
+		// Bit 0: the exit is on the right edge rather than the top
+		uint32_t flags;
+		int32_t startX;
+		int32_t startY;
+		int32_t exitX;
+		int32_t exitY;
+
+		// Rows of the wall planes (height + 1 in all) per section
+		int32_t sectionRows;
+		uint32_t reserved;
+
+		// FMazeGrid::ComputeWallHash of the planes, for an optional integrity check
+		uint64_t wallHash;
+	};
+	static_assert(sizeof(FMazeFileHeader) == 64, "The maze file header is 64 bytes on disk");
+
+	// Header describing a grid and how it was generated
+	FMazeFileHeader MakeMazeFileHeader(const FMazeGrid& grid, uint64_t seed, EMazeGenAlgorithm algorithm, const FMazeEndpoints& endpoints,
+		int32_t sectionRows = DefaultMazeFileSectionRows);
+
+	// Total file size in bytes, header included
+	size_t GetMazeFileSize(const FMazeFileHeader& header);
+
+	int32_t GetMazeFileSectionCount(const FMazeFileHeader& header);
+
+	FMazeEndpoints GetMazeFileEndpoints(const FMazeFileHeader& header);
+
+	// Writes the header and wall planes into outData, which must hold GetMazeFileSize bytes
+	void WriteMazeFile(const FMazeGrid& grid, const FMazeFileHeader& header, uint8_t* outData);
+
+	// Copies the header out of a file and checks it describes a file of this size.
+	// Returns false for anything that is not a complete maze file of this version.
+	bool ReadMazeFileHeader(const uint8_t* data, size_t size, FMazeFileHeader& outHeader);
+
+	// Copies one section's rows into a grid already initialised to the header's size
+	void ReadMazeFileSection(const uint8_t* data, const FMazeFileHeader& header, int32_t section, FMazeGrid& grid);
+
+	// Loads a whole maze file into a grid. The grid and header are only changed when the whole read
+	// succeeds. With bVerifyHash the walls are also checked against the hash in the header,
+	// which reads the planes a second time. The visited flags are generator scratch and are not stored.
+	bool ReadMazeFile(const uint8_t* data, size_t size, FMazeGrid& outGrid, FMazeFileHeader& outHeader, bool bVerifyHash = false);
+
+	// Receives size bytes of a file being streamed, to be written at offset. Returns false to stop.
+	using FMazeFileWriteFunc = std::function<bool(size_t offset, const uint8_t* data, size_t size)>;
+
+	// Generates an Eller maze straight into a maze file a section at a time, so the maze is never held
+	// whole: memory is O(width * sectionRows) for any height. The file is byte for byte the one
+	// WriteMazeFile makes of GenerateMazeFromSeed with EMazeGenAlgorithm::Eller and the same seed.
+	// Sections are written in order and the header last, at offset 0, once the wall hash is known.
+	// Returns false if a write failed or the generation was cancelled.
+	bool StreamEllerMazeFile(int32_t width, int32_t height, uint64_t seed, const FMazeFileWriteFunc& write, FMazeFileHeader& outHeader,
+		int32_t sectionRows = DefaultMazeFileSectionRows, const FMazeCancelFlag* cancel = nullptr);
+}
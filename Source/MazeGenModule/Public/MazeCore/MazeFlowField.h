@@ -0,0 +1,76 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeFlowField
+// Purpose: One direction byte per cell pointing one step along the shortest path to the nearest goal.
+// Built once by a multi-source breadth-first search and shared by every agent, which then steers with
+// a single lookup instead of running its own path query. Adding a goal only relaxes the cells that
+// end up closer to it; removing one rebuilds the field.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	// Step stored per cell in a flow field
+	enum class EMazeFlowDirection : uint8_t
+	{
+		West,
+		East,
+		South,
+		North,
+		AtGoal,
+		Unreachable
+	};
+
+	class FMazeFlowField
+	{
+	public:
+		// Binds the field to a grid with no goals (every cell unreachable)
+		void Init(const FMazeGrid& grid);
+
+		// Reads a grid with the same walls from now on, such as the one the field was built on after a move
+		void Rebind(const FMazeGrid& grid) { m_grid = &grid; }
+
+		// Adds a goal and updates only the cells that are now closer to a goal
+		void AddGoal(int32_t x, int32_t y);
+
+		// Removes a goal and rebuilds the field from the remaining ones
+		void RemoveGoal(int32_t x, int32_t y);
+
+		// Removes every goal
+		void ClearGoals();
+
+		// Rebuilds the whole field from the goal list. Call after walls of the grid were opened or closed.
+		void Rebuild();
+
+		int32_t GetGoalCount() const { return int32_t(m_goals.size()); }
+
+		EMazeFlowDirection GetDirection(int32_t x, int32_t y) const { return EMazeFlowDirection(m_directions[m_grid->GetCellIndex(x, y)]); }
+
+		// Steps to the nearest goal, or -1 if no goal can be reached
+		int32_t GetDistance(int32_t x, int32_t y) const
+		{
+			const int32_t distance = m_distances[m_grid->GetCellIndex(x, y)];
+			return distance == Unreached ? -1 : distance;
+		}
+
+		size_t GetAllocatedSize() const;
+
+	private:
+		static constexpr int32_t Unreached = INT32_MAX;
+
+		// Breadth-first relaxation from the cells already in the queue
+		void Propagate(size_t tail);
+
+		const FMazeGrid* m_grid = nullptr;
+		std::vector<int32_t> m_goals;
+
+		// The field agents read, one EMazeFlowDirection per cell
+		std::vector<uint8_t> m_directions;
+
+		// Steps to the nearest goal, kept so a new goal only has to relax the cells it improves
+		std::vector<int32_t> m_distances;
+		std::vector<int32_t> m_queue;
+	};
+}
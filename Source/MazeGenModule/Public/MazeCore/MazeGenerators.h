@@ -0,0 +1,89 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Maze generation algorithms that carve passages into an FMazeGrid.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+#include "MazeCore/MazeRandom.h"
+
+#include <atomic>
+
+namespace MazeCore
+{
+	// Identifies a generation algorithm outside of the engine (mirrors EMazeAlgorithm)
+	enum class EMazeGenAlgorithm : uint8_t
+	{
+		RecursiveBacktracker,
+		IterativeBacktracker,
+		Wilson,
+		ParallelTiles,
+		Eller,
+		Kruskal,
+		Prim
+	};
+
+	// Short lowercase name of an algorithm, for logs and benchmarks
+	const char* GetAlgorithmName(EMazeGenAlgorithm algorithm);
+
+	// Entrance and exit cells of a maze. The entrance opens to the west and the exit
+	// opens to the east when bExitOnRightEdge is set, otherwise to the north.
+	struct FMazeEndpoints
+	{
+		int32_t startX = 0;
+		int32_t startY = 0;
+		int32_t exitX = 0;
+		int32_t exitY = 0;
+		bool bExitOnRightEdge = true;
+	};
+
+	// Generators take an optional cancellation flag. When another thread sets it the generator
+	// stops early and leaves the grid partially carved; callers check the flag afterwards.
+	using FMazeCancelFlag = std::atomic<bool>;
+
+	// Depth-first search with one call per cell. Overflows the stack on large mazes.
+	void GenerateRecursiveBacktracker(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel = nullptr);
+
+	// Depth-first search driven by an explicit stack of packed cell indices
+	void GenerateIterativeBacktracker(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel = nullptr);
+
+	// Iterative backtracker confined to the cells in [minX, maxX) x [minY, maxY). Walls on the border
+	// of the rectangle stay closed and no cell outside it is read or written.
+	void GenerateIterativeBacktrackerInRect(FMazeGrid& grid, FMazeRandom& random, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY,
+		int32_t startX, int32_t startY, const FMazeCancelFlag* cancel = nullptr);
+
+	// Wilson's algorithm: loop-erased random walks grow a uniform spanning tree, so every possible
+	// maze is equally likely (no long-corridor bias). Uses one direction byte per cell.
+	void GenerateWilson(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel = nullptr);
+
+	// Randomized Kruskal: removes walls in random order whenever they separate two different sets.
+	// Many short dead ends. The start cell is not used.
+	void GenerateKruskal(FMazeGrid& grid, FMazeRandom& random, const FMazeCancelFlag* cancel = nullptr);
+
+	// Randomized Prim: grows the maze from the start cell by attaching a random frontier cell at a time.
+	// Radial look with many short branches.
+	void GeneratePrim(FMazeGrid& grid, FMazeRandom& random, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel = nullptr);
+
+	// Runs the requested algorithm starting from (startX, startY). threadCount is passed to
+	// GenerateTiledMaze for EMazeGenAlgorithm::ParallelTiles (0 for one thread per core); the maze
+	// does not depend on it.
+	void GenerateMaze(FMazeGrid& grid, FMazeRandom& random, EMazeGenAlgorithm algorithm, int32_t startX, int32_t startY, const FMazeCancelFlag* cancel = nullptr,
+		int32_t threadCount = 0);
+
+	// Picks an entrance at (0,0) and an exit on the right or top edge
+	FMazeEndpoints ChooseEndpoints(const FMazeGrid& grid, FMazeRandom& random);
+
+	// The same for a maze that is never held in a grid
+	FMazeEndpoints ChooseEndpoints(int32_t width, int32_t height, FMazeRandom& random);
+
+	// Opens the outer walls at the entrance and exit
+	void OpenEndpoints(FMazeGrid& grid, const FMazeEndpoints& endpoints);
+
+	// Builds a complete maze (walls, passages and openings) from nothing but its parameters.
+	// The same seed always produces the same maze.
+	FMazeEndpoints GenerateMazeFromSeed(FMazeGrid& grid, int32_t width, int32_t height, EMazeGenAlgorithm algorithm, uint64_t seed,
+		const FMazeCancelFlag* cancel = nullptr, int32_t threadCount = 0);
+
+	// Random binary choice per cell to rotate its wall
+	void GenerateTurnMaze(FMazeTurnGrid& turnGrid, FMazeRandom& random);
+}
@@ -0,0 +1,167 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeGrid, FMazeTurnGrid
+// Purpose: Flat, row-major maze grids that pack every cell into a few bits.
+// FMazeGrid stores each shared wall once: a bitplane of south walls and a bitplane of west walls.
+// The north wall of a cell is the south wall of the cell above it, and the east wall is the
+// west wall of the cell to its right. An extra row and column hold the top and right borders.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MazeCore
+{
+	// FMazeGrid::ComputeWallHash runs this over the south plane and then the west plane, starting from
+	// MazeWallHashBasis, so a writer that never holds the planes whole can hash them the same way
+	constexpr uint64_t MazeWallHashBasis = 0xCBF29CE484222325ull;
+	uint64_t HashMazeWallWords(uint64_t hash, const uint64_t* words, size_t count);
+
+	class FMazeGrid
+	{
+	public:
+		// Resizes the grid with every wall closed and no cell visited
+		void Init(int32_t width, int32_t height);
+
+		int32_t GetWidth() const { return m_width; }
+		int32_t GetHeight() const { return m_height; }
+		int32_t GetCellCount() const { return m_width * m_height; }
+
+		// Packed row-major cell index
+		int32_t GetCellIndex(int32_t x, int32_t y) const { return y * m_width + x; }
+
+		bool HasSouthWall(int32_t x, int32_t y) const { return GetBit(m_southWalls, x, y); }
+		bool HasNorthWall(int32_t x, int32_t y) const { return GetBit(m_southWalls, x, y + 1); }
+		bool HasWestWall(int32_t x, int32_t y) const { return GetBit(m_westWalls, x, y); }
+		bool HasEastWall(int32_t x, int32_t y) const { return GetBit(m_westWalls, x + 1, y); }
+
+		void SetSouthWall(int32_t x, int32_t y, bool bWall) { SetBit(m_southWalls, x, y, bWall); }
+		void SetNorthWall(int32_t x, int32_t y, bool bWall) { SetBit(m_southWalls, x, y + 1, bWall); }
+		void SetWestWall(int32_t x, int32_t y, bool bWall) { SetBit(m_westWalls, x, y, bWall); }
+		void SetEastWall(int32_t x, int32_t y, bool bWall) { SetBit(m_westWalls, x + 1, y, bWall); }
+
+		// Walls by grid line: horizontal line y (0 to height) runs along the bottom of row y,
+		// vertical line x (0 to width) runs along the left of column x
+		bool HasHorizontalWall(int32_t x, int32_t line) const { return GetBit(m_southWalls, x, line); }
+		bool HasVerticalWall(int32_t line, int32_t y) const { return GetBit(m_westWalls, line, y); }
+
+		bool IsVisited(int32_t x, int32_t y) const { return GetBit(m_visited, x, y); }
+		void SetVisited(int32_t x, int32_t y) { SetBit(m_visited, x, y, true); }
+
+		// Removes the wall between two orthogonally adjacent cells
+		void RemoveWallBetween(int32_t x, int32_t y, int32_t nx, int32_t ny)
+		{
+			if (nx < x) {
+				SetWestWall(x, y, false);
+			}
+			else if (nx > x) {
+				SetEastWall(x, y, false);
+			}
+			else if (ny < y) {
+				SetSouthWall(x, y, false);
+			}
+			else {
+				SetNorthWall(x, y, false);
+			}
+		}
+
+		// Packed indices of the neighbours reachable through open walls (at most four).
+		// Openings in the outer border lead nowhere and are skipped.
+		int32_t GetOpenNeighbors(int32_t x, int32_t y, int32_t outNeighbors[4]) const
+		{
+			const int32_t cell = GetCellIndex(x, y);
+			int32_t count = 0;
+			if (x > 0 && !HasWestWall(x, y)) {
+				outNeighbors[count++] = cell - 1;
+			}
+			if (x < m_width - 1 && !HasEastWall(x, y)) {
+				outNeighbors[count++] = cell + 1;
+			}
+			if (y > 0 && !HasSouthWall(x, y)) {
+				outNeighbors[count++] = cell - m_width;
+			}
+			if (y < m_height - 1 && !HasNorthWall(x, y)) {
+				outNeighbors[count++] = cell + m_width;
+			}
+			return count;
+		}
+
+		// Raw wall planes for saving and loading: (height + 1) rows of GetWordsPerRow() words each,
+		// with bit x of a row at bit (x & 63) of word (x >> 6)
+		int32_t GetWordsPerRow() const { return m_wordsPerRow; }
+		uint64_t* GetSouthWallWords() { return m_southWalls.data(); }
+		uint64_t* GetWestWallWords() { return m_westWalls.data(); }
+		const uint64_t* GetSouthWallWords() const { return m_southWalls.data(); }
+		const uint64_t* GetWestWallWords() const { return m_westWalls.data(); }
+
+		// Bytes held by the bitplanes
+		size_t GetAllocatedSize() const;
+
+		// Hash of the wall planes. Identical mazes hash the same on every platform.
+		uint64_t ComputeWallHash() const;
+
+		// Closed cell edges, outer border included
+		int64_t CountWalls() const;
+
+	private:
+		// Rows are padded to whole words so a row never shares a word with the next one
+		bool GetBit(const std::vector<uint64_t>& plane, int32_t x, int32_t y) const
+		{
+			return (plane[size_t(y) * m_wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+		}
+
+		void SetBit(std::vector<uint64_t>& plane, int32_t x, int32_t y, bool bValue)
+		{
+			uint64_t& word = plane[size_t(y) * m_wordsPerRow + (x >> 6)];
+			const uint64_t mask = uint64_t(1) << (x & 63);
+			word = bValue ? (word | mask) : (word & ~mask);
+		}
+
+		int32_t m_width = 0;
+		int32_t m_height = 0;
+		int32_t m_wordsPerRow = 0;
+
+		// (width + 1) x (height + 1) bits each, so the borders have somewhere to live
+		std::vector<uint64_t> m_southWalls;
+		std::vector<uint64_t> m_westWalls;
+
+		// width x height bits
+		std::vector<uint64_t> m_visited;
+	};
+
+	// One bit per cell: set when the cell's wall is rotated by the turn algorithm
+	class FMazeTurnGrid
+	{
+	public:
+		void Init(int32_t width, int32_t height);
+
+		int32_t GetWidth() const { return m_width; }
+		int32_t GetHeight() const { return m_height; }
+
+		bool IsRotated(int32_t x, int32_t y) const
+		{
+			const size_t cell = size_t(y) * m_width + x;
+			return (m_rotated[cell >> 6] >> (cell & 63)) & 1;
+		}
+
+		void SetRotated(int32_t x, int32_t y, bool bRotated)
+		{
+			const size_t cell = size_t(y) * m_width + x;
+			const uint64_t mask = uint64_t(1) << (cell & 63);
+			m_rotated[cell >> 6] = bRotated ? (m_rotated[cell >> 6] | mask) : (m_rotated[cell >> 6] & ~mask);
+		}
+
+		// Raw bits, 64 cells per word in row-major order
+		uint64_t* GetWords() { return m_rotated.data(); }
+		size_t GetWordCount() const { return m_rotated.size(); }
+
+		size_t GetAllocatedSize() const { return m_rotated.capacity() * sizeof(uint64_t); }
+
+	private:
+		int32_t m_width = 0;
+		int32_t m_height = 0;
+		std::vector<uint64_t> m_rotated;
+	};
+}
@@ -0,0 +1,70 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Converts a maze grid into floor and wall instance placements.
+// The placements are plain floats; the actors turn them into FTransforms for their
+// instanced static mesh components.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	// Location and scale of a single mesh instance (no rotation)
+	struct FMazeInstance
+	{
+		float x, y, z;
+		float scaleX, scaleY, scaleZ;
+	};
+
+	// How the floor is instanced (mirrors EMazeFloorMode)
+	enum class EMazeFloorLayout : uint8_t
+	{
+		// One floor mesh scaled to cover the whole grid
+		SingleSlab,
+		// One floor mesh per cell, for when cells need to differ
+		PerCell
+	};
+
+	// Mirrors the "Maze Settings" and "Mesh ZOffset" properties of the actors
+	struct FMazeLayoutSettings
+	{
+		float positionScaling = 200.0f;
+		float meshScaleX = 1.0f;
+		float meshScaleY = 1.0f;
+		float meshScaleZ = 1.0f;
+		float zOffset = 0.1f;
+
+		// Collapse consecutive collinear walls into one stretched instance. The wall mesh is
+		// scaled from its pivot at the start of the cell edge, the same point a single wall uses.
+		bool bMergeWalls = true;
+
+		EMazeFloorLayout floorLayout = EMazeFloorLayout::SingleSlab;
+	};
+
+	// Instances for each of the three mesh components
+	struct FMazeLayout
+	{
+		std::vector<FMazeInstance> floors;
+		std::vector<FMazeInstance> horizontalWalls;
+		std::vector<FMazeInstance> verticalWalls;
+
+		void Reset();
+		size_t GetInstanceCount() const { return floors.size() + horizontalWalls.size() + verticalWalls.size(); }
+	};
+
+	// Placement of a run of walls starting at a position along a grid line: horizontal runs lie on line y
+	// and start at x, vertical runs lie on line x and start at y
+	FMazeInstance MakeWallInstance(bool bHorizontal, int32_t line, int32_t start, int32_t length, const FMazeLayoutSettings& settings);
+
+	// One floor per cell and one wall per closed edge. Walls shared by two cells are placed once.
+	void BuildMazeLayout(const FMazeGrid& grid, const FMazeLayoutSettings& settings, FMazeLayout& layout);
+
+	// Turn maze layout: the floor and one wall per cell. Walls the turn grid leaves as they are go in
+	// horizontalWalls and rotated ones in verticalWalls, unrotated; the actor applies the rotation.
+	void BuildTurnMazeLayout(const FMazeTurnGrid& turnGrid, const FMazeLayoutSettings& settings, FMazeLayout& layout);
+
+	// Layout for one chunk of a streamed maze. Like BuildMazeLayout, but the north and east
+	// borders are left to the neighbouring chunks.
+	void BuildChunkLayout(const FMazeGrid& grid, const FMazeLayoutSettings& settings, FMazeLayout& layout);
+}
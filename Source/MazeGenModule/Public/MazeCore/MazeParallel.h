@@ -0,0 +1,33 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Multithreaded maze generation by tiles.
+// The grid is split into square tiles whose width is a multiple of 64 cells, so no two tiles share a
+// word of any bitplane and each tile can be carved on its own thread without locking. Every tile is a
+// perfect maze seeded from (seed, tile index). A random spanning tree over the tiles then opens one
+// wall on each border it uses, which joins the tiles into a single perfect maze.
+// The result depends only on the seed and the tile size, never on the number of threads.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGenerators.h"
+
+namespace MazeCore
+{
+	// Tile size used by GenerateMaze for EMazeGenAlgorithm::ParallelTiles
+	constexpr int32_t DefaultMazeTileSize = 256;
+
+	// Rounds a tile size up to a whole number of 64-bit words (at least 64 cells)
+	int32_t GetAlignedTileSize(int32_t tileSize);
+
+	// Number of tiles along each axis. Tiles on the right and top edges may be smaller.
+	void GetTileCounts(const FMazeGrid& grid, int32_t tileSize, int32_t& outTilesX, int32_t& outTilesY);
+
+	// Carves one tile into an initialised grid. Safe to call concurrently for different tiles.
+	void GenerateMazeTile(FMazeGrid& grid, uint64_t seed, int32_t tileSize, int32_t tileIndex, const FMazeCancelFlag* cancel = nullptr);
+
+	// Opens one wall on every tile border used by a random spanning tree over the tiles
+	void JoinMazeTiles(FMazeGrid& grid, uint64_t seed, int32_t tileSize);
+
+	// Carves every tile on threadCount threads (0 uses one per hardware thread), then joins them
+	void GenerateTiledMaze(FMazeGrid& grid, uint64_t seed, int32_t tileSize, int32_t threadCount = 0, const FMazeCancelFlag* cancel = nullptr);
+}
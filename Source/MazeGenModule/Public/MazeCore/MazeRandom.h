@@ -0,0 +1,121 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeRandom
+// Purpose: Small, fast, seedable random number generator used by the maze generators.
+// xoshiro256** seeded through SplitMix64. Only integer arithmetic is used, so the same seed
+// produces the same sequence (and the same maze) on every platform and compiler.
+// Random bits are drawn from a buffered 64-bit word, so a coin flip or a choice between a
+// handful of neighbours costs a shift instead of a full generator step.
+// License: MIT
+#pragma once
+
+#include <cstdint>
+
+namespace MazeCore
+{
+	// Combines a seed with another value into a new, well mixed seed.
+	// Used to derive independent streams, e.g. one per chunk, from a single maze seed.
+	inline uint64_t MixSeed(uint64_t seed, uint64_t value)
+	{
+		uint64_t z = seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	class FMazeRandom
+	{
+	public:
+		explicit FMazeRandom(uint64_t seed = 0) { Seed(seed); }
+
+		void Seed(uint64_t seed)
+		{
+			uint64_t splitMix = seed;
+			for (uint64_t& word : m_state) {
+				word = SplitMix64(splitMix);
+			}
+			m_bitBuffer = 0;
+			m_bitCount = 0;
+		}
+
+		// Next 64 random bits (xoshiro256**)
+		uint64_t Next()
+		{
+			const uint64_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+			const uint64_t t = m_state[1] << 17;
+			m_state[2] ^= m_state[0];
+			m_state[3] ^= m_state[1];
+			m_state[1] ^= m_state[2];
+			m_state[0] ^= m_state[3];
+			m_state[2] ^= t;
+			m_state[3] = RotateLeft(m_state[3], 45);
+			return result;
+		}
+
+		// Next 'count' (1 to 32) random bits from the buffered word
+		uint32_t NextBits(int32_t count)
+		{
+			if (m_bitCount < count) {
+				m_bitBuffer = Next();
+				m_bitCount = 64;
+			}
+			const uint32_t bits = uint32_t(m_bitBuffer & ((uint64_t(1) << count) - 1));
+			m_bitBuffer >>= count;
+			m_bitCount -= count;
+			return bits;
+		}
+
+		bool RandBool() { return NextBits(1) != 0; }
+
+		// Uniform integer in [0, bound). Draws only as many bits as the bound needs and rejects
+		// the values past it, so there is no modulo bias.
+		uint32_t NextBelow(uint32_t bound)
+		{
+			if (bound <= 1) {
+				return 0;
+			}
+			const int32_t bitCount = BitWidth(bound - 1);
+			uint32_t value;
+			do {
+				value = NextBits(bitCount);
+			} while (value >= bound);
+			return value;
+		}
+
+		// Uniform integer in [min, max]
+		int32_t RandRange(int32_t min, int32_t max)
+		{
+			return int32_t(int64_t(min) + NextBelow(uint32_t(int64_t(max) - int64_t(min) + 1)));
+		}
+
+	private:
+		// Number of bits needed to hold value (at least 1), without a loop per bit
+		static int32_t BitWidth(uint32_t value)
+		{
+			int32_t bits = 0;
+			if (value >= (1u << 16)) { value >>= 16; bits += 16; }
+			if (value >= (1u << 8)) { value >>= 8; bits += 8; }
+			if (value >= (1u << 4)) { value >>= 4; bits += 4; }
+			if (value >= (1u << 2)) { value >>= 2; bits += 2; }
+			if (value >= (1u << 1)) { value >>= 1; bits += 1; }
+			bits += int32_t(value);
+			return bits > 0 ? bits : 1;
+		}
+
+		static uint64_t RotateLeft(uint64_t value, int32_t shift)
+		{
+			return (value << shift) | (value >> (64 - shift));
+		}
+
+		static uint64_t SplitMix64(uint64_t& state)
+		{
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		uint64_t m_state[4];
+		uint64_t m_bitBuffer = 0;
+		int32_t m_bitCount = 0;
+	};
+}
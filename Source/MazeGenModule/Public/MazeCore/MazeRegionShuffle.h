@@ -0,0 +1,131 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeRegionShuffle
+// Purpose: Re-randomises a rectangle of a finished maze while it is being played, keeping it perfect.
+// Without the rectangle the rest of the maze falls apart into pieces that were joined only through it.
+// The shuffle finds those pieces with a union-find in one pass over the rows, carves a new maze inside
+// the rectangle, and opens exactly one wall on its border into every piece, so the maze is again a
+// single tree. The work is done a bounded number of cells at a time so it can be spread over frames.
+// The grid only changes in the last step, a few rows of the region at a time, and every wall it
+// changed is listed for the mesh update.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeDisjointSet.h"
+#include "MazeCore/MazeGrid.h"
+#include "MazeCore/MazeRandom.h"
+
+namespace MazeCore
+{
+	// A cell edge on a grid line: a horizontal line runs along the bottom of row 'line', a vertical
+	// line along the left of column 'line' (see FMazeGrid)
+	struct FMazeWallEdge
+	{
+		bool bHorizontal;
+		int32_t line;
+		int32_t position;
+	};
+
+	class FMazeRegionShuffle
+	{
+	public:
+		// Starts shuffling the cells in [minX, minX + width) x [minY, minY + height), clamped to the grid.
+		// Returns false if nothing of the rectangle is left. The grid must not change size until the
+		// shuffle is finished, and every wall edit made meanwhile has to be passed to NoteWallEdit.
+		bool Start(const FMazeGrid& grid, int32_t minX, int32_t minY, int32_t width, int32_t height, uint64_t seed);
+
+		// Allocates the per-cell scratch for shuffles of this grid, so Start stays proportional to the
+		// region. Without it the first Label steps allocate as they go. Cancels a running shuffle.
+		void Reserve(const FMazeGrid& grid);
+
+		// Tells a running shuffle about a wall edit, after the grid has it. An opened wall outside the
+		// region joins its two pieces, keeping the maze a tree. Walls in and on the region are written
+		// over by the shuffle unless their row is already in, and a closed wall outside it is left as
+		// the edit made it.
+		void NoteWallEdit(const FMazeWallEdge& edge, bool bWall);
+
+		void Cancel() { m_step = EStep::Idle; }
+
+		bool IsRunning() const { return m_step != EStep::Idle && m_step != EStep::Done; }
+		bool IsDone() const { return m_step == EStep::Done; }
+
+		// True once the grid has started to change. From then on the shuffle has to run to the end.
+		bool HasChangedGrid() const { return (m_step == EStep::Apply && m_nextRow >= 0) || m_step == EStep::Done; }
+
+		// Does up to about workLimit cells of work. Returns true once the grid holds the new region.
+		bool Advance(FMazeGrid& grid, int32_t workLimit);
+
+		// Walls the finished shuffle opened or closed
+		const std::vector<FMazeWallEdge>& GetChangedWalls() const { return m_changedWalls; }
+
+		int32_t GetMinX() const { return m_minX; }
+		int32_t GetMinY() const { return m_minY; }
+		int32_t GetWidth() const { return m_width; }
+		int32_t GetHeight() const { return m_height; }
+
+		size_t GetAllocatedSize() const;
+
+	private:
+		enum class EStep : uint8_t
+		{
+			Idle,
+			// Join the cells outside the region into pieces, row by row
+			Label,
+			// Backtracker inside the region, on a grid of its own
+			Carve,
+			// Pick one border wall per piece, then write the region into the grid row by row
+			Apply,
+			Done
+		};
+
+		// A wall on the region's border with the cell outside it
+		struct FBorderWall
+		{
+			FMazeWallEdge edge;
+			int32_t outsideCell;
+		};
+
+		bool IsInRegion(int32_t x, int32_t y) const
+		{
+			return x >= m_minX && x < m_minX + m_width && y >= m_minY && y < m_minY + m_height;
+		}
+
+		int32_t Label(const FMazeGrid& grid, int32_t workLimit);
+		int32_t Carve(int32_t workLimit);
+		int32_t Apply(FMazeGrid& grid, int32_t workLimit);
+
+		// Numbers the pieces and picks the opening of each among its border walls
+		void ChooseOpenings();
+
+		// Sets a wall of the grid, listing it if it changed
+		void SetWall(FMazeGrid& grid, const FMazeWallEdge& edge, bool bWall);
+
+		EStep m_step = EStep::Idle;
+		int32_t m_minX = 0;
+		int32_t m_minY = 0;
+		int32_t m_width = 0;
+		int32_t m_height = 0;
+		int32_t m_gridWidth = 0;
+		int32_t m_gridHeight = 0;
+		uint64_t m_seed = 0;
+		FMazeRandom m_random;
+
+		std::vector<FBorderWall> m_borderWalls;
+
+		// Pieces over every cell of the grid, and the next cell to join. Cells are added as the
+		// scan reaches them, so no step has to set the whole array.
+		FMazeDisjointSet m_pieces;
+		int32_t m_nextCell = 0;
+
+		// The backtracker's path through the region
+		std::vector<int32_t> m_stack;
+
+		// Per border wall: it is its piece's opening. Then the next row of the region to write,
+		// or -1 before the openings are picked.
+		std::vector<uint8_t> m_bOpenings;
+		int32_t m_nextRow = -1;
+
+		FMazeGrid m_region;
+		std::vector<FMazeWallEdge> m_changedWalls;
+	};
+}
@@ -0,0 +1,85 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeSolver
+// Purpose: Queries over a generated maze grid (reachability, validation, distances and paths).
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	// Number of cells reachable from (x, y) through open walls
+	int32_t CountReachableCells(const FMazeGrid& grid, int32_t x, int32_t y);
+
+	// Number of open walls between cells inside the grid (border openings are not counted)
+	int64_t CountPassages(const FMazeGrid& grid);
+
+	// True when every cell is reachable and there are no loops (a spanning tree)
+	bool IsPerfectMaze(const FMazeGrid& grid);
+
+	// Distance field and shortest path queries over one grid. All buffers are sized once by Init and
+	// reused, and a per-query epoch marks which entries are current, so a query never clears or
+	// allocates and costs only the cells it actually visits.
+	class FMazeSolver
+	{
+	public:
+		// Binds the solver to a grid and sizes its buffers. Call again whenever the grid is regenerated.
+		void Init(const FMazeGrid& grid);
+
+		// Points the solver at another grid of the same size, keeping its buffers and last query. Used
+		// when the grid it was initialised with is moved into place.
+		void Rebind(const FMazeGrid& grid) { m_grid = &grid; }
+
+		// Breadth-first distances (in steps) from a cell to every reachable cell.
+		// Read them with GetDistance until the next query.
+		void ComputeDistanceField(int32_t x, int32_t y);
+
+		// Distance to a cell from the last query's start, or -1 if it was not reached
+		int32_t GetDistance(int32_t x, int32_t y) const
+		{
+			const int32_t cell = m_grid->GetCellIndex(x, y);
+			return IsCurrent(cell) ? m_distance[cell] : -1;
+		}
+
+		// Path from a cell back to the last distance field's start, read from the BFS parents in
+		// O(path length) with no search. Writes packed cell indices starting at (x, y) and returns
+		// the number of steps, or -1 if the cell was not reached. Many agents heading for the same
+		// target can share one field this way.
+		int32_t GetPathToFieldStart(int32_t x, int32_t y, std::vector<int32_t>& outPath) const;
+
+		// A* with a Manhattan heuristic. Writes the packed cell indices from start to goal (both
+		// included) and returns the number of steps, or -1 if the goal cannot be reached.
+		int32_t FindPath(int32_t startX, int32_t startY, int32_t goalX, int32_t goalY, std::vector<int32_t>& outPath);
+
+		size_t GetAllocatedSize() const;
+
+	private:
+		// Starts a new query; every stamp from earlier queries becomes stale
+		void BeginQuery();
+
+		// True when the cell was reached by the current query
+		bool IsCurrent(int32_t cell) const { return m_stamp[cell] == m_epoch; }
+
+		// Sets the distance and parent of a cell for the current query
+		void Visit(int32_t cell, int32_t distance, int32_t parent)
+		{
+			m_stamp[cell] = m_epoch;
+			m_distance[cell] = distance;
+			m_parent[cell] = parent;
+		}
+
+		const FMazeGrid* m_grid = nullptr;
+		uint32_t m_epoch = 0;
+
+		// Per cell: query stamp, distance from the start and previous cell on the path.
+		// Separate arrays keep path reads, which only follow parents, dense in the cache.
+		std::vector<uint32_t> m_stamp;
+		std::vector<int32_t> m_distance;
+		std::vector<int32_t> m_parent;
+
+		// BFS queue, and the A* open list as a binary heap of (estimate << 32 | cell)
+		std::vector<int32_t> m_queue;
+		std::vector<uint64_t> m_openHeap;
+	};
+}
@@ -0,0 +1,69 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeTreeIndex
+// Purpose: Constant time distance and path membership queries between any two cells of a perfect maze.
+// A maze without loops is a tree, so the distance between two cells is their depths from the root minus
+// twice the depth of their lowest common ancestor. Cells are numbered in depth-first preorder, where
+// the shallowest cell strictly after one cell and up to another is a child of their common ancestor,
+// so that depth is a range minimum over the preorder depths. The range minimum uses a sparse table over
+// blocks of 32 depths plus a scan inside the two end blocks.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	class FMazeTreeIndex
+	{
+	public:
+		// Indexes a grid with no loops (every generated maze, or a forest after walls were added).
+		// Returns false and leaves the index empty if the grid has a loop. Rebuild after the grid changes.
+		bool Build(const FMazeGrid& grid);
+
+		bool IsBuilt() const { return !m_preorder.empty(); }
+
+		// Steps between two cells, or -1 when no path joins them
+		int32_t GetDistance(int32_t ax, int32_t ay, int32_t bx, int32_t by) const
+		{
+			return GetCellDistance(GetCellIndex(ax, ay), GetCellIndex(bx, by));
+		}
+
+		// True when a cell lies on the path between two others (ends included)
+		bool IsOnPath(int32_t x, int32_t y, int32_t ax, int32_t ay, int32_t bx, int32_t by) const;
+
+		size_t GetAllocatedSize() const;
+
+	private:
+		static constexpr int32_t BlockShift = 5;
+		static constexpr int32_t BlockSize = 1 << BlockShift;
+
+		int32_t GetCellIndex(int32_t x, int32_t y) const { return y * m_width + x; }
+
+		int32_t GetCellDistance(int32_t a, int32_t b) const;
+
+		// Smallest depth at preorder positions first to last (inclusive)
+		int32_t GetMinDepth(int32_t first, int32_t last) const;
+
+		// Smallest depth in the blocks first to last (inclusive) from the sparse table
+		int32_t GetMinBlockDepth(int32_t first, int32_t last) const;
+
+		// Tree that a preorder position belongs to
+		int32_t GetTree(int32_t position) const;
+
+		int32_t m_width = 0;
+
+		// Per cell: its preorder position
+		std::vector<int32_t> m_preorder;
+
+		// Per preorder position: depth from the root of its tree
+		std::vector<int32_t> m_depths;
+
+		// Level k holds, for every block, the smallest depth in the 2^k blocks starting there
+		std::vector<int32_t> m_blockMinima;
+		int32_t m_blockCount = 0;
+
+		// First preorder position of every tree, in order (a single 0 for a perfect maze)
+		std::vector<int32_t> m_treeStarts;
+	};
+}
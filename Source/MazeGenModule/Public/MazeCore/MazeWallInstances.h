@@ -0,0 +1,99 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeWallInstances
+// Purpose: Keeps the wall instances of one orientation in step with walls opened and closed at runtime,
+// so an edit only touches the instances it affects instead of rebuilding the mesh component.
+// Every instance is a run of closed edges along one grid line (a single edge without wall merging),
+// numbered exactly as BuildMazeLayout lists them. Every edge maps to its run, and every run to its
+// instance index. Removing a run moves the last instance into its slot, so instances stay dense and
+// only ever shrink from the end. Changed instances are listed until Commit, for a batched update of
+// the component.
+// Part of the engine-independent maze core: plain C++, no Unreal types.
+// License: MIT
+#pragma once
+
+#include "MazeCore/MazeGrid.h"
+
+namespace MazeCore
+{
+	// A straight run of closed walls along one grid line
+	struct FMazeWallRun
+	{
+		int32_t line;
+		int32_t start;
+		int32_t length;
+	};
+
+	class FMazeWallInstances
+	{
+	public:
+		// Takes the runs from the grid in the order BuildMazeLayout places them, horizontal walls (lines
+		// along X, the default wall component) or vertical walls (lines along Y, the rotated wall component).
+		// Starts committed, matching a component filled from that layout.
+		void Build(const FMazeGrid& grid, bool bHorizontal, bool bMergeWalls);
+
+		bool IsBuilt() const { return !m_edgeRuns.empty(); }
+		bool IsHorizontal() const { return m_bHorizontal; }
+
+		// Closes or opens the edge at a position along a line, merging or splitting runs.
+		// Returns false if the edge already was that way. The grid is not changed.
+		bool SetWall(int32_t line, int32_t position, bool bWall);
+
+		bool HasWall(int32_t line, int32_t position) const { return m_edgeRuns[GetEdgeIndex(line, position)] >= 0; }
+
+		// Instance drawing an edge, or -1 when the edge is open
+		int32_t GetInstanceAt(int32_t line, int32_t position) const;
+
+		int32_t GetInstanceCount() const { return int32_t(m_instanceRuns.size()); }
+		const FMazeWallRun& GetInstanceRun(int32_t instance) const { return m_runs[m_instanceRuns[instance]]; }
+
+		// Instance count when Commit was last called, the number the component holds
+		int32_t GetCommittedCount() const { return m_committedCount; }
+
+		// Instances below the committed count whose run changed since the last Commit, unordered
+		const std::vector<int32_t>& GetDirtyInstances() const { return m_dirtyInstances; }
+
+		bool HasChanges() const { return !m_dirtyInstances.empty() || GetInstanceCount() != m_committedCount; }
+
+		// Call once the component matches: dirty instances updated, instances past the count removed
+		// and new ones added
+		void Commit();
+
+		size_t GetAllocatedSize() const;
+
+	private:
+		int32_t GetEdgeIndex(int32_t line, int32_t position) const { return line * m_lineLength + position; }
+
+		// Takes a free run id and appends its instance
+		int32_t AddRun(int32_t line, int32_t start, int32_t length);
+
+		// Frees a run whose edges were already handed over, moving the last instance into its slot
+		void RemoveRun(int32_t run);
+
+		// Points the edges of a run at it
+		void AssignEdges(int32_t run);
+
+		void MarkDirty(int32_t run);
+
+		bool m_bHorizontal = true;
+		bool m_bMergeWalls = true;
+		int32_t m_lineCount = 0;
+		int32_t m_lineLength = 0;
+
+		// Per edge: id of the run drawing it, or -1 when open
+		std::vector<int32_t> m_edgeRuns;
+
+		// Per run id. Ids stay put while instance indices move.
+		std::vector<FMazeWallRun> m_runs;
+		std::vector<int32_t> m_runInstances;
+		std::vector<int32_t> m_freeRuns;
+
+		// Per instance: its run id
+		std::vector<int32_t> m_instanceRuns;
+
+		int32_t m_committedCount = 0;
+		std::vector<int32_t> m_dirtyInstances;
+
+		// Per committed instance: already in m_dirtyInstances
+		std::vector<uint8_t> m_bDirty;
+	};
+}
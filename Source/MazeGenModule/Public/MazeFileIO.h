@@ -0,0 +1,26 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeFileIO
+// Purpose: Saves and loads maze files (see MazeCore/MazeFile.h) through the engine's file system.
+// Loading maps the file into memory and copies the wall planes straight out of the mapping.
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeCore/MazeFile.h"
+
+struct MAZEGENMODULE_API FMazeFileIO
+{
+	// Writes a grid with its header. Missing directories are created.
+	static bool Save(const FString& filePath, const MazeCore::FMazeGrid& grid, const MazeCore::FMazeFileHeader& header);
+
+	// Generates an Eller maze straight into a file, a section of rows at a time, without building a grid
+	// (see MazeCore::StreamEllerMazeFile). A file that could not be finished is deleted.
+	static bool SaveEllerStream(const FString& filePath, int32 width, int32 height, uint64 seed, MazeCore::FMazeFileHeader& outHeader);
+
+	// Reads a maze file into a grid. Returns false, leaving the grid untouched, if the file is missing
+	// or is not a valid maze file.
+	static bool Load(const FString& filePath, MazeCore::FMazeGrid& outGrid, MazeCore::FMazeFileHeader& outHeader);
+
+	// Relative paths are taken from the project directory
+	static FString ResolvePath(const FString& filePath);
+};
@@ -0,0 +1,120 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeGenCache
+// Purpose: Memory and disk cache of generated mazes, keyed on every setting that affects the result.
+// An entry holds the wall grid, its entrance and exit, and the finished instance transforms, so a maze
+// that was built before (in an earlier PIE session, or by another server process) skips both generation
+// and transform building. Memory entries are evicted least recently used first once they pass
+// MazeGen.Cache.MaxMemoryMB, and cache files are trimmed the same way past MazeGen.Cache.MaxDiskMB.
+// Entries are immutable once added and may be shared between threads.
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "MazeCore/MazeGenerators.h"
+#include "MazeCore/MazeLayout.h"
+#include "MazeGenTypes.h"
+#include "MazeInstanceBuffers.h"
+
+// Pipeline that produced an entry; the actors share seeds but not results
+enum class EMazeCacheKind : uint8
+{
+	Backtrace,
+	Turn
+};
+
+struct MAZEGENMODULE_API FMazeGenCacheKey
+{
+	EMazeCacheKind kind = EMazeCacheKind::Backtrace;
+	uint32 algorithm = 0;
+	uint64 seed = 0;
+	int32 width = 0;
+	int32 height = 0;
+
+	// Hash of every setting that changes the instance transforms
+	uint64 layoutHash = 0;
+
+	static FMazeGenCacheKey MakeBacktrace(MazeCore::EMazeGenAlgorithm algorithm, uint64 seed, int32 width, int32 height,
+		const MazeCore::FMazeLayoutSettings& settings);
+
+	static FMazeGenCacheKey MakeTurn(uint64 seed, int32 width, int32 height, float positionScaling, float wallRotationDeg,
+		const FVector& meshScaling, EMazeFloorMode floorMode);
+
+	// 64-bit hash of all fields, also used to name the cache file
+	uint64 GetHash64() const;
+
+	bool operator==(const FMazeGenCacheKey& other) const
+	{
+		return kind == other.kind && algorithm == other.algorithm && seed == other.seed && width == other.width
+			&& height == other.height && layoutHash == other.layoutHash;
+	}
+
+	friend uint32 GetTypeHash(const FMazeGenCacheKey& key) { return uint32(key.GetHash64()); }
+};
+
+struct MAZEGENMODULE_API FMazeGenCacheEntry
+{
+	// Empty for turn mazes, which keep no grid after the transforms are built
+	MazeCore::FMazeGrid grid;
+	MazeCore::FMazeEndpoints endpoints;
+	FMazeInstanceBuffers instances;
+
+	int64 GetAllocatedSize() const;
+};
+
+using FMazeGenCacheEntryPtr = TSharedPtr<const FMazeGenCacheEntry, ESPMode::ThreadSafe>;
+
+struct FMazeGenCacheStats
+{
+	int64 memoryHits = 0;
+	int64 diskHits = 0;
+	int64 misses = 0;
+	int64 evictions = 0;
+	int64 memoryBytes = 0;
+	int32 entryCount = 0;
+};
+
+class MAZEGENMODULE_API FMazeGenCache
+{
+public:
+	static FMazeGenCache& Get();
+
+	// Looks in memory first, then on disk. An entry read from disk is kept in memory.
+	// Returns null on a miss. Thread-safe.
+	FMazeGenCacheEntryPtr Find(const FMazeGenCacheKey& key);
+
+	// Keeps an entry in memory, evicting the least recently used ones past the memory cap, and writes
+	// its cache file on a background thread. The entry must not change afterwards. Thread-safe.
+	void Add(const FMazeGenCacheKey& key, const FMazeGenCacheEntryPtr& entry);
+
+	// Drops every memory entry, and the cache files as well with bDeleteFiles
+	void Clear(bool bDeleteFiles);
+
+	FMazeGenCacheStats GetStats() const;
+
+	// Saved/MazeCache in the project directory
+	static FString GetCacheDirectory();
+
+private:
+	struct FSlot
+	{
+		FMazeGenCacheEntryPtr entry;
+		int64 bytes = 0;
+		uint64 lastUse = 0;
+	};
+
+	// Keeps an entry in memory; the caller holds the lock
+	void AddToMemory(const FMazeGenCacheKey& key, const FMazeGenCacheEntryPtr& entry);
+
+	static FString GetCacheFilePath(const FMazeGenCacheKey& key);
+	static FMazeGenCacheEntryPtr LoadFromDisk(const FMazeGenCacheKey& key);
+	static bool SaveToDisk(const FMazeGenCacheKey& key, const FMazeGenCacheEntry& entry);
+
+	// Deletes the oldest cache files until the directory fits the disk cap
+	static void TrimDisk();
+
+	mutable FCriticalSection m_lock;
+	TMap<FMazeGenCacheKey, FSlot> m_entries;
+	uint64 m_useCounter = 0;
+	FMazeGenCacheStats m_stats;
+};
@@ -0,0 +1,25 @@
+// Author: Joshua Hall - Griffith University
+// Class: UMazeGenCommandlet
+// Purpose: Pre-generates a batch of mazes into maze files for the content pipeline, with no world,
+// rendering or actors. Mazes are generated in parallel, one per task, across every core.
+// Run with:
+//   UnrealEditor-Cmd SimpleMazeGenerator.uproject -run=MazeGen -algorithm=wilson -width=256 -height=256 -seed=0 -count=1000 -out=Saved/Mazes
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MazeGenCommandlet.generated.h"
+
+UCLASS()
+class MAZEGENMODULE_API UMazeGenCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMazeGenCommandlet();
+
+	// Generates mazes for seeds [seed, seed + count) and writes one file per seed. Returns 0 when
+	// every maze was written.
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,68 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeGenStats
+// Purpose: Instrumentation for maze generation. Every stage has a cycle stat in the MazeGen group
+// ("stat MazeGen") and a CPU trace event on the MazeGen channel for Unreal Insights
+// ("-trace=cpu,MazeGen"). Counters hold the cells, walls, instances and bytes of every live maze.
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeGenTypes.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("MazeGen"), STATGROUP_MazeGen, STATCAT_Advanced);
+
+// Generation stages
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Maze Meshes"), STAT_MazeGen_GenerateMeshes, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Allocate Grid"), STAT_MazeGen_AllocateGrid, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Maze"), STAT_MazeGen_GenerateMaze, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Init Solvers"), STAT_MazeGen_InitSolvers, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Transforms"), STAT_MazeGen_BuildTransforms, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Add Instances"), STAT_MazeGen_AddInstances, STATGROUP_MazeGen, MAZEGENMODULE_API);
+
+// Runtime changes to a maze
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flush Wall Edits"), STAT_MazeGen_FlushWallEdits, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh Solvers"), STAT_MazeGen_RefreshSolvers, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Shift Region"), STAT_MazeGen_ShiftRegion, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Wall Instances Updated"), STAT_MazeGen_WallInstanceUpdates, STATGROUP_MazeGen, MAZEGENMODULE_API);
+
+// Totals over every live maze
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cells"), STAT_MazeGen_Cells, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Walls"), STAT_MazeGen_Walls, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Wall Instances"), STAT_MazeGen_WallInstances, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Floor Instances"), STAT_MazeGen_FloorInstances, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Grid Memory"), STAT_MazeGen_GridMemory, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Transform Memory"), STAT_MazeGen_TransformMemory, STATGROUP_MazeGen, MAZEGENMODULE_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Solver Memory"), STAT_MazeGen_SolverMemory, STATGROUP_MazeGen, MAZEGENMODULE_API);
+
+UE_TRACE_CHANNEL_EXTERN(MazeGenChannel, MAZEGENMODULE_API);
+
+// Times a scope for "stat MazeGen" and Unreal Insights
+#define MAZEGEN_SCOPE(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, MazeGenChannel)
+
+// MAZEGEN_SCOPE that also adds the scope's time to a field of a generation summary
+#define MAZEGEN_STAGE_SCOPE(Stat, OutMs) \
+	MAZEGEN_SCOPE(Stat); \
+	FMazeGenStageTimer PREPROCESSOR_JOIN(mazeGenStageTimer, __LINE__)(OutMs)
+
+// Adds the wall clock time until the end of its scope to a millisecond field. Works in shipping
+// builds, where the stats above compile away.
+struct FMazeGenStageTimer
+{
+	explicit FMazeGenStageTimer(float& outMs) : m_outMs(outMs), m_startTime(FPlatformTime::Seconds()) {}
+	~FMazeGenStageTimer() { m_outMs += float((FPlatformTime::Seconds() - m_startTime) * 1000.0); }
+
+private:
+	float& m_outMs;
+	double m_startTime;
+};
+
+struct MAZEGENMODULE_API FMazeGenStats
+{
+	// Adds a finished maze to the counters, or takes it away again when it is replaced or destroyed
+	static void AddMaze(const FMazeGenerationSummary& summary);
+	static void RemoveMaze(const FMazeGenerationSummary& summary);
+};
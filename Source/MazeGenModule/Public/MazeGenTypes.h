@@ -0,0 +1,128 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Types shared by the maze actors (algorithm selection and generation events).
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeGenTypes.generated.h"
+
+// Algorithm used to carve the backtracking maze (mirrors MazeCore::EMazeGenAlgorithm)
+UENUM(BlueprintType)
+enum class EMazeAlgorithm : uint8
+{
+	// Original recursive depth-first search (one stack frame per cell, small mazes only)
+	RecursiveBacktracker,
+	// Depth-first search driven by an explicit stack of packed cell indices
+	IterativeBacktracker,
+	// Wilson's algorithm: uniform spanning tree, every maze equally likely (more branches, shorter corridors)
+	Wilson,
+	// Backtracker mazes carved in 256x256 tiles on every core, then joined into one perfect maze
+	ParallelTiles,
+	// Eller's algorithm: built row by row, keeping only one row of state (long horizontal passages)
+	Eller,
+	// Randomized Kruskal: walls removed in random order (many short dead ends)
+	Kruskal,
+	// Randomized Prim: grown outward from the entrance (radial, many short branches)
+	Prim
+};
+
+// How the maze floor is instanced (mirrors MazeCore::EMazeFloorLayout)
+UENUM(BlueprintType)
+enum class EMazeFloorMode : uint8
+{
+	// One floor instance scaled to cover the whole maze (or chunk)
+	SingleSlab,
+	// One floor instance per cell, only needed when cells look different
+	PerCell
+};
+
+// Side of a cell a wall is on. North is +Y and east is +X in the maze actor's space.
+UENUM(BlueprintType)
+enum class EMazeWallSide : uint8
+{
+	North,
+	East,
+	South,
+	West
+};
+
+// What one maze generation produced and how long each stage took, in wall clock milliseconds.
+// Returned by GenerateMazeMeshes so automation can log it (ToString) and compare it across builds.
+USTRUCT(BlueprintType)
+struct MAZEGENMODULE_API FMazeGenerationSummary
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int32 width = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int32 height = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int64 seed = 0;
+
+	// Taken from the generation cache, so nothing was generated or built
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	bool bFromCache = false;
+
+	// Generated and built on a worker thread, so only adding the instances ran on the game thread
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	bool bAsync = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int32 cellCount = 0;
+
+	// Closed cell edges, outer border included
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int32 wallCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int32 wallInstanceCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int32 floorInstanceCount = 0;
+
+	// Bytes held by the grid
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int64 gridBytes = 0;
+
+	// Bytes of the instance transforms handed to the mesh components
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int64 transformBytes = 0;
+
+	// Bytes held by the solvers, flow field, distance index and wall edit maps
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	int64 solverBytes = 0;
+
+	// Sizing the grid with every wall closed
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	float allocateMs = 0.0f;
+
+	// Carving the maze (or loading it from a file) and opening the entrance and exit
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	float generateMs = 0.0f;
+
+	// Building the distance field, flow field and distance index
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	float solversMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	float buildTransformsMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	float addInstancesMs = 0.0f;
+
+	// From the start of generation until the instances were added, waiting for a worker included
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|Stats")
+	float totalMs = 0.0f;
+
+	// One line of key=value pairs for logs
+	FString ToString() const;
+};
+
+// Broadcast on the game thread once a maze has been generated and its instances added
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnMazeGenerated);
+
+// Broadcast on the game thread once a shifted region is in the grid and all of its wall instances are updated
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnMazeRegionShifted, FIntPoint, minCell, FIntPoint, size);
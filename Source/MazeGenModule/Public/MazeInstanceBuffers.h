@@ -0,0 +1,39 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeInstanceBuffers
+// Purpose: Transform arrays for the floor, default wall and rotated wall instanced meshes.
+// Buffers can be filled on any thread; only AddTo must run on the game thread.
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeCore/MazeGrid.h"
+#include "MazeCore/MazeLayout.h"
+#include "MazeGenTypes.h"
+
+class UInstancedStaticMeshComponent;
+
+struct MAZEGENMODULE_API FMazeInstanceBuffers
+{
+	TArray<FTransform> floors;
+	TArray<FTransform> defaultWalls;
+	TArray<FTransform> rotatedWalls;
+
+	void Reset();
+	int32 Num() const { return floors.Num() + defaultWalls.Num() + rotatedWalls.Num(); }
+	SIZE_T GetAllocatedSize() const { return floors.GetAllocatedSize() + defaultWalls.GetAllocatedSize() + rotatedWalls.GetAllocatedSize(); }
+
+	// Converts a maze core layout (horizontal walls go to the default wall mesh). Vertical walls
+	// are turned by verticalWallYawDeg, which the turn maze uses for its rotated walls.
+	void BuildFromLayout(const MazeCore::FMazeLayout& layout, float verticalWallYawDeg = 0.0f);
+
+	// Transform of a single maze core instance placement
+	static FTransform ToTransform(const MazeCore::FMazeInstance& instance);
+
+	// Adds every buffer to its component in one call each
+	void AddTo(UInstancedStaticMeshComponent* floorComponent, UInstancedStaticMeshComponent* defaultWallComponent,
+		UInstancedStaticMeshComponent* rotatedWallComponent, bool bWorldSpace = false) const;
+
+	// Removes the instances of a previous maze, so a new one is not added on top of it
+	static void ClearFrom(UInstancedStaticMeshComponent* floorComponent, UInstancedStaticMeshComponent* defaultWallComponent,
+		UInstancedStaticMeshComponent* rotatedWallComponent);
+};
@@ -0,0 +1,26 @@
+// Author: Joshua Hall - Griffith University
+// Class: FMazeMeshComponents
+// Purpose: Creates the instanced mesh components used by the maze actors, either plain instanced
+// static meshes or hierarchical ones. Hierarchical components group their instances into spatial
+// clusters, so visibility culling and LOD selection work per cluster instead of on the whole maze.
+// License: MIT
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UInstancedStaticMeshComponent;
+
+struct MAZEGENMODULE_API FMazeMeshComponents
+{
+	// Creates and registers a static component attached to the owner's root component. A static
+	// component cannot move once registered, so its location is set here.
+	static UInstancedStaticMeshComponent* Create(AActor* owner, bool bHierarchical, const FVector& relativeLocation = FVector::ZeroVector);
+
+	// Swaps the component for a new, empty one when it is not already of the requested kind.
+	// Call before assigning meshes and materials.
+	static void SetHierarchical(AActor* owner, UInstancedStaticMeshComponent*& component, bool bHierarchical);
+
+	// Instances fade out from 90% of the distance and are culled past it. 0 never culls.
+	static void SetCullDistance(UInstancedStaticMeshComponent* component, float cullDistance);
+};
@@ -3,6 +3,7 @@
 #include "SimpleMazeGeneratorProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "ABacktrace_MazeGen.h"
 
 ASimpleMazeGeneratorProjectile::ASimpleMazeGeneratorProjectile() 
 {
@@ -33,6 +34,14 @@ ASimpleMazeGeneratorProjectile::ASimpleMazeGeneratorProjectile()
 
 void ASimpleMazeGeneratorProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	// Break the maze wall edge that was hit (needs bEnableWallEdits on the maze)
+	AABacktrace_MazeGen* maze = Cast<AABacktrace_MazeGen>(OtherActor);
+	if (maze && maze->RemoveWallAtLocation(Hit.ImpactPoint, Hit.ImpactNormal))
+	{
+		Destroy();
+		return;
+	}
+
 	// Only add impulse and destroy projectile if we hit a physics
 	if ((OtherActor != nullptr) && (OtherActor != this) && (OtherComp != nullptr) && OtherComp->IsSimulatingPhysics())
 	{
@@ -0,0 +1,1287 @@
+// Author: Joshua Hall - Griffith University
+// Purpose: Headless benchmark for the engine-independent maze core.
+// Generates square mazes with each generator from 64x64 up to the maximum size and reports throughput, allocations
+// and memory, then times the instance layout with and without wall merging, runtime wall edits and region shuffles.
+// The generation and layout results can be written to a JSON baseline (--json) and checked against one (--baseline):
+// the run fails when any of them got slower, or allocates more, by more than the threshold.
+// Usage: MazeBench [--min N] [--max N] [--verify] [--repeat N] [--json FILE] [--baseline FILE] [--threshold PERCENT]
+// License: MIT
+
+#include "MazeCore/MazeEller.h"
+#include "MazeCore/MazeFile.h"
+#include "MazeCore/MazeCorridorGraph.h"
+#include "MazeCore/MazeFlowField.h"
+#include "MazeCore/MazeGenerators.h"
+#include "MazeCore/MazeLayout.h"
+#include "MazeCore/MazeParallel.h"
+#include "MazeCore/MazeRegionShuffle.h"
+#include "MazeCore/MazeSolver.h"
+#include "MazeCore/MazeTreeIndex.h"
+#include "MazeCore/MazeWallInstances.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#endif
+
+/*===================
+GetResidentMemoryMB
+
+The memory the process holds in RAM right now, or -1 where the platform gives no way to read it.
+Unlike the peak, it also goes down, so the difference over a measurement belongs to that measurement.
+===================*/
+static double GetResidentMemoryMB()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.WorkingSetSize / (1024.0 * 1024.0);
+	}
+#elif defined(__APPLE__)
+	mach_task_basic_info_data_t info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+		return info.resident_size / (1024.0 * 1024.0);
+	}
+#else
+	// The second field of statm is the resident set in pages
+	if (FILE* file = std::fopen("/proc/self/statm", "r"))
+	{
+		long pages = 0;
+		long residentPages = 0;
+		const bool bRead = std::fscanf(file, "%ld %ld", &pages, &residentPages) == 2;
+		std::fclose(file);
+		if (bRead) {
+			return double(residentPages) * double(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+		}
+	}
+#endif
+	return -1.0;
+}
+
+/*===================
+ResetPeakResidentMemory
+
+Linux can set the peak resident memory back to the current one, so the peak of a single
+measurement can be read after it. Returns false on platforms that cannot.
+===================*/
+static bool ResetPeakResidentMemory()
+{
+#if defined(__linux__)
+	if (FILE* file = std::fopen("/proc/self/clear_refs", "w"))
+	{
+		const bool bWritten = std::fputs("5", file) >= 0;
+		return std::fclose(file) == 0 && bWritten;
+	}
+#endif
+	return false;
+}
+
+// The peak resident memory since ResetPeakResidentMemory, or -1 if it could not be read
+static double GetPeakResidentMemoryMB()
+{
+#if defined(__linux__)
+	if (FILE* file = std::fopen("/proc/self/status", "r"))
+	{
+		char line[256];
+		long peakKB = -1;
+		while (peakKB < 0 && std::fgets(line, sizeof(line), file)) {
+			std::sscanf(line, "VmHWM: %ld kB", &peakKB);
+		}
+		std::fclose(file);
+		if (peakKB >= 0) {
+			return peakKB / 1024.0;
+		}
+	}
+#endif
+	return -1.0;
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Every allocation through new is counted, so each measurement can report the allocations it made
+static std::atomic<uint64_t> s_allocationCount(0);
+static std::atomic<uint64_t> s_allocatedBytes(0);
+
+void* operator new(std::size_t size)
+{
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size > 0 ? size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+// One measurement of the regression suite, keyed by name and size
+struct FBenchResult
+{
+	std::string name;
+	int32_t size = 0;
+	double ms = 0.0;
+	double mcellsPerSec = 0.0;
+	uint64_t allocations = 0;
+	double allocatedMB = 0.0;
+	// Resident memory the measurement added, or -1 if it could not be read
+	double residentMB = 0.0;
+};
+
+// Prints a resident memory figure into a column, as n/a where it could not be read
+static const char* FormatResidentMB(double residentMB, char (&buffer)[16])
+{
+	if (residentMB < 0.0) {
+		return "n/a";
+	}
+	std::snprintf(buffer, sizeof(buffer), "%.1f", residentMB);
+	return buffer;
+}
+
+/*===================
+Measure
+
+Runs setup (untimed) and then run, repeat times, and keeps the fastest. A run shorter than
+MinBatchMs is repeated, with its setup each time, until the runs add up to it, and counts as the
+average of the batch, so short results are as steady as long ones. Allocations are those of the
+last run, as every run makes the same ones. The resident memory is the most that setup and
+run together added to the process: their peak on Linux, elsewhere only what is still held at the
+end of run.
+===================*/
+template <typename SetupFunc, typename RunFunc>
+static FBenchResult Measure(const char* name, int32_t size, int32_t repeat, SetupFunc&& setup, RunFunc&& run)
+{
+	static const double MinBatchMs = 50.0;
+
+	FBenchResult result;
+	result.name = name;
+	result.size = size;
+	for (int32_t i = 0; i < repeat; i++)
+	{
+		const double residentBefore = GetResidentMemoryMB();
+		const bool bPeakReset = ResetPeakResidentMemory();
+		double batchSeconds = 0.0;
+		int32_t runCount = 0;
+		do
+		{
+			setup();
+			const uint64_t allocationCount = s_allocationCount.load();
+			const uint64_t allocatedBytes = s_allocatedBytes.load();
+			const auto start = std::chrono::steady_clock::now();
+			run();
+			batchSeconds += SecondsSince(start);
+			runCount++;
+
+			result.allocations = s_allocationCount.load() - allocationCount;
+			result.allocatedMB = (s_allocatedBytes.load() - allocatedBytes) / (1024.0 * 1024.0);
+		} while (batchSeconds * 1000.0 < MinBatchMs);
+
+		const double runMs = batchSeconds * 1000.0 / runCount;
+		if (i == 0 || runMs < result.ms) {
+			result.ms = runMs;
+		}
+
+		const double residentAfter = bPeakReset ? GetPeakResidentMemoryMB() : GetResidentMemoryMB();
+		if (residentBefore < 0.0 || residentAfter < 0.0) {
+			result.residentMB = -1.0;
+		}
+		else if (result.residentMB >= 0.0) {
+			result.residentMB = std::max(result.residentMB, residentAfter - residentBefore);
+		}
+	}
+	result.mcellsPerSec = result.ms > 0.0 ? double(size) * double(size) / (result.ms / 1000.0) / 1.0e6 : 0.0;
+	return result;
+}
+
+/*===================
+BenchGeneration
+
+Times every generator at every size: the non-recursive ones across the whole sweep, the
+recursive backtracker only where its recursion fits the stack, and the turn maze. Returns false
+if --verify found a maze that is not perfect.
+===================*/
+static bool BenchGeneration(int32_t minSize, int32_t maxSize, int32_t repeat, bool bVerify, std::vector<FBenchResult>& results)
+{
+	// One stack frame per cell of the longest path
+	static const int32_t RecursiveMaxSize = 64;
+	static const MazeCore::EMazeGenAlgorithm algorithms[] = {
+		MazeCore::EMazeGenAlgorithm::RecursiveBacktracker,
+		MazeCore::EMazeGenAlgorithm::IterativeBacktracker,
+		MazeCore::EMazeGenAlgorithm::Wilson,
+		MazeCore::EMazeGenAlgorithm::ParallelTiles,
+		MazeCore::EMazeGenAlgorithm::Eller,
+		MazeCore::EMazeGenAlgorithm::Kruskal,
+		MazeCore::EMazeGenAlgorithm::Prim
+	};
+
+	std::printf("%-22s %11s %10s %12s %10s %10s %10s %10s\n", "algorithm", "size", "ms", "Mcells/s", "allocs", "alloc MB", "grid MB", "rss+ MB");
+
+	bool bAllPerfect = true;
+	for (const MazeCore::EMazeGenAlgorithm algorithm : algorithms) {
+		for (int32_t size = minSize; size <= maxSize; size *= 2)
+		{
+			if (algorithm == MazeCore::EMazeGenAlgorithm::RecursiveBacktracker && size > RecursiveMaxSize) {
+				break;
+			}
+
+			MazeCore::FMazeGrid grid;
+			MazeCore::FMazeRandom random;
+			const std::string name = std::string("generate/") + MazeCore::GetAlgorithmName(algorithm);
+			const FBenchResult result = Measure(name.c_str(), size, repeat,
+				[&]() { grid.Init(size, size); random.Seed(uint64_t(size)); },
+				[&]() { MazeCore::GenerateMaze(grid, random, algorithm, 0, 0); });
+			results.push_back(result);
+
+			char residentText[16];
+			std::printf("%-22s %5d x %-5d %10.2f %12.2f %10llu %10.2f %10.2f %10s", MazeCore::GetAlgorithmName(algorithm), size, size,
+				result.ms, result.mcellsPerSec, (unsigned long long)result.allocations, result.allocatedMB,
+				grid.GetAllocatedSize() / (1024.0 * 1024.0), FormatResidentMB(result.residentMB, residentText));
+
+			if (bVerify) {
+				const bool bPerfect = MazeCore::IsPerfectMaze(grid);
+				bAllPerfect = bAllPerfect && bPerfect;
+				std::printf("  %s  hash %016llx", bPerfect ? "perfect" : "NOT PERFECT", (unsigned long long)grid.ComputeWallHash());
+			}
+			std::printf("\n");
+		}
+	}
+
+	for (int32_t size = minSize; size <= maxSize; size *= 2)
+	{
+		MazeCore::FMazeTurnGrid turnGrid;
+		MazeCore::FMazeRandom random;
+		const FBenchResult result = Measure("generate/turn", size, repeat,
+			[&]() { turnGrid.Init(size, size); random.Seed(uint64_t(size)); },
+			[&]() { MazeCore::GenerateTurnMaze(turnGrid, random); });
+		results.push_back(result);
+
+		char residentText[16];
+		std::printf("%-22s %5d x %-5d %10.2f %12.2f %10llu %10.2f %10.2f %10s\n", "turn", size, size, result.ms, result.mcellsPerSec,
+			(unsigned long long)result.allocations, result.allocatedMB, turnGrid.GetAllocatedSize() / (1024.0 * 1024.0),
+			FormatResidentMB(result.residentMB, residentText));
+	}
+	return bAllPerfect;
+}
+
+/*===================
+BenchParallelScaling
+
+Times the tiled generator at the largest size with 1, 2, 4, ... threads up to the hardware thread
+count and reports the speedup over one thread. Returns false if the thread count changed the maze,
+which would break determinism.
+===================*/
+static bool BenchParallelScaling(int32_t size)
+{
+	const int32_t hardwareThreads = std::max(1, int32_t(std::thread::hardware_concurrency()));
+	std::printf("\n%-22s %11s %10s %10s %12s %10s\n", "parallel-tiles", "size", "threads", "ms", "Mcells/s", "speedup");
+
+	double singleThreadTime = 0.0;
+	uint64_t singleThreadHash = 0;
+	bool bDeterministic = true;
+	for (int32_t threads = 1; ; threads = std::min(threads * 2, hardwareThreads))
+	{
+		MazeCore::FMazeGrid grid;
+		grid.Init(size, size);
+
+		const auto start = std::chrono::steady_clock::now();
+		MazeCore::GenerateTiledMaze(grid, uint64_t(size), MazeCore::DefaultMazeTileSize, threads);
+		const double elapsed = SecondsSince(start);
+
+		const uint64_t hash = grid.ComputeWallHash();
+		if (threads == 1) {
+			singleThreadTime = elapsed;
+			singleThreadHash = hash;
+		}
+		bDeterministic = bDeterministic && hash == singleThreadHash;
+
+		std::printf("%-22s %5d x %-5d %10d %10.2f %12.2f %9.2fx%s\n", "", size, size, threads, elapsed * 1000.0,
+			double(size) * double(size) / elapsed / 1.0e6, singleThreadTime / elapsed, hash == singleThreadHash ? "" : "  HASH MISMATCH");
+
+		if (threads == hardwareThreads) {
+			break;
+		}
+	}
+	return bDeterministic;
+}
+
+/*===================
+BenchEllerStreaming
+
+Streams a maze 4 times taller than it is wide through Eller's generator without ever building
+a grid, and reports the throughput and the generator's memory, which depends only on the width.
+===================*/
+static void BenchEllerStreaming(int32_t size)
+{
+	const int32_t height = size * 4;
+	std::printf("\n%-22s %11s %10s %12s %12s %10s %18s\n", "eller-stream", "width", "rows", "ms", "Mcells/s", "state KB", "checksum");
+
+	MazeCore::FMazeEllerGenerator generator;
+	generator.Init(size, uint64_t(size));
+
+	// Fold every row into a checksum so the rows are actually consumed
+	uint64_t checksum = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (int32_t y = 0; y < height; y++) {
+		const MazeCore::FMazeRowWalls& row = generator.NextRow(y == height - 1);
+		checksum = MazeCore::MixSeed(checksum, row.northWalls[0] ^ row.westWalls[0]);
+	}
+	const double elapsed = SecondsSince(start);
+
+	std::printf("%-22s %11d %10d %12.2f %12.2f %10.1f   %016llx\n", "", size, height, elapsed * 1000.0,
+		double(size) * double(height) / elapsed / 1.0e6, generator.GetAllocatedSize() / 1024.0, (unsigned long long)checksum);
+}
+
+/*===================
+BenchSolver
+
+Times full distance fields, A* queries and path reads from a cached distance field between random
+cells of one maze, with the solver's buffers reused throughout. Returns false if A* ever disagrees
+with the distance field.
+===================*/
+static bool BenchSolver(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %12s %12s %10s\n", "solver", "size", "queries", "ms", "us/query", "avg steps");
+
+	MazeCore::FMazeGrid grid;
+	MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+	MazeCore::FMazeSolver solver;
+	solver.Init(grid);
+
+	MazeCore::FMazeRandom random(1);
+	std::vector<int32_t> path;
+	const char* names[] = { "distance-field", "a-star", "cached-field-path" };
+	const int32_t queryCounts[] = { 20, 20, 1000 };
+	for (int32_t mode = 0; mode < 3; mode++)
+	{
+		if (mode == 2) {
+			solver.ComputeDistanceField(size - 1, size - 1);
+		}
+
+		int64_t totalSteps = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int32_t i = 0; i < queryCounts[mode]; i++)
+		{
+			const int32_t x = random.RandRange(0, size - 1);
+			const int32_t y = random.RandRange(0, size - 1);
+			if (mode == 0) {
+				solver.ComputeDistanceField(x, y);
+				totalSteps += solver.GetDistance(size - 1, size - 1);
+			}
+			else if (mode == 1) {
+				totalSteps += solver.FindPath(x, y, size - 1, size - 1, path);
+			}
+			else {
+				totalSteps += solver.GetPathToFieldStart(x, y, path);
+			}
+		}
+		const double elapsed = SecondsSince(start);
+		std::printf("%-22s %5d x %-5d %10d %12.2f %12.2f %10.1f\n", names[mode], size, size, queryCounts[mode],
+			elapsed * 1000.0, elapsed * 1.0e6 / queryCounts[mode], double(totalSteps) / queryCounts[mode]);
+	}
+
+	// Spot check: A* path lengths match a distance field
+	solver.ComputeDistanceField(0, 0);
+	std::vector<int32_t> expected;
+	for (int32_t i = 0; i < 10; i++) {
+		const int32_t x = random.RandRange(0, size - 1);
+		const int32_t y = random.RandRange(0, size - 1);
+		expected.push_back(x);
+		expected.push_back(y);
+		expected.push_back(solver.GetDistance(x, y));
+	}
+	bool bConsistent = true;
+	for (size_t i = 0; i < expected.size(); i += 3) {
+		const int32_t steps = solver.FindPath(0, 0, expected[i], expected[i + 1], path);
+		bConsistent = bConsistent && steps == expected[i + 2] && int32_t(path.size()) == steps + 1;
+	}
+	if (!bConsistent) {
+		std::printf("A* and distance field DISAGREE\n");
+	}
+	return bConsistent;
+}
+
+/*===================
+BenchFlowField
+
+Times a flow field build to one goal, adding goals incrementally, and 1000 agents walking to the
+nearest goal by lookup alone. Returns false if the incremental field differs from a full rebuild.
+===================*/
+static bool BenchFlowField(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %12s\n", "flow-field", "size", "count", "ms");
+
+	MazeCore::FMazeGrid grid;
+	MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+	MazeCore::FMazeFlowField field;
+	field.Init(grid);
+
+	auto start = std::chrono::steady_clock::now();
+	field.AddGoal(size - 1, size - 1);
+	std::printf("%-22s %5d x %-5d %10d %12.2f\n", "build", size, size, 1, SecondsSince(start) * 1000.0);
+
+	MazeCore::FMazeRandom random(2);
+	const int32_t goalCount = 16;
+	start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < goalCount; i++) {
+		const int32_t goalX = random.RandRange(0, size - 1);
+		const int32_t goalY = random.RandRange(0, size - 1);
+		field.AddGoal(goalX, goalY);
+	}
+	std::printf("%-22s %5d x %-5d %10d %12.2f\n", "add-goal", size, size, goalCount, SecondsSince(start) * 1000.0);
+
+	// Walk agents to their nearest goal using only the direction bytes
+	const int32_t agentCount = 1000;
+	int64_t steps = 0;
+	start = std::chrono::steady_clock::now();
+	for (int32_t agent = 0; agent < agentCount; agent++)
+	{
+		int32_t x = random.RandRange(0, size - 1);
+		int32_t y = random.RandRange(0, size - 1);
+		for (MazeCore::EMazeFlowDirection direction = field.GetDirection(x, y);
+			direction != MazeCore::EMazeFlowDirection::AtGoal && direction != MazeCore::EMazeFlowDirection::Unreachable;
+			direction = field.GetDirection(x, y))
+		{
+			x += direction == MazeCore::EMazeFlowDirection::East ? 1 : direction == MazeCore::EMazeFlowDirection::West ? -1 : 0;
+			y += direction == MazeCore::EMazeFlowDirection::North ? 1 : direction == MazeCore::EMazeFlowDirection::South ? -1 : 0;
+			steps++;
+		}
+	}
+	const double walkTime = SecondsSince(start);
+	std::printf("%-22s %5d x %-5d %10d %12.2f  (%lld steps, %.1f ns/step)\n", "agent-walk", size, size, agentCount,
+		walkTime * 1000.0, (long long)steps, walkTime * 1.0e9 / double(steps > 0 ? steps : 1));
+
+	// The incremental field must match one rebuilt from the same goals
+	MazeCore::FMazeRandom replay(2);
+	MazeCore::FMazeFlowField rebuilt;
+	rebuilt.Init(grid);
+	rebuilt.AddGoal(size - 1, size - 1);
+	std::vector<int32_t> goals;
+	for (int32_t i = 0; i < goalCount; i++) {
+		goals.push_back(replay.RandRange(0, size - 1));
+		goals.push_back(replay.RandRange(0, size - 1));
+	}
+	for (size_t i = 0; i < goals.size(); i += 2) {
+		rebuilt.AddGoal(goals[i], goals[i + 1]);
+		rebuilt.RemoveGoal(goals[i], goals[i + 1]);
+		rebuilt.AddGoal(goals[i], goals[i + 1]);
+	}
+	bool bMatches = true;
+	for (int32_t y = 0; y < size && bMatches; y++) {
+		for (int32_t x = 0; x < size; x++) {
+			bMatches = bMatches && field.GetDistance(x, y) == rebuilt.GetDistance(x, y);
+		}
+	}
+	if (!bMatches) {
+		std::printf("incremental flow field DIFFERS from rebuild\n");
+	}
+	return bMatches;
+}
+
+/*===================
+IsValidPath
+
+True when a path of packed cell indices runs from start to goal through open walls only.
+===================*/
+static bool IsValidPath(const MazeCore::FMazeGrid& grid, const std::vector<int32_t>& path, int32_t start, int32_t goal)
+{
+	if (path.empty() || path.front() != start || path.back() != goal) {
+		return false;
+	}
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		int32_t neighbors[4];
+		const int32_t count = grid.GetOpenNeighbors(path[i - 1] % grid.GetWidth(), path[i - 1] / grid.GetWidth(), neighbors);
+		if (std::find(neighbors, neighbors + count, path[i]) == neighbors + count) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*===================
+BenchCorridorGraph
+
+Compresses mazes to their junctions and dead ends and times the same A* and distance field
+queries on the full grid and on the compressed graph. Returns false if any graph path has a
+different length from the grid's or does not follow open walls.
+===================*/
+static bool BenchCorridorGraph(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %10s %10s %10s %12s %12s\n", "corridor-graph", "size", "nodes", "edges", "build ms", "MB",
+		"grid us/q", "graph us/q");
+
+	const MazeCore::EMazeGenAlgorithm algorithms[] = {
+		MazeCore::EMazeGenAlgorithm::IterativeBacktracker,
+		MazeCore::EMazeGenAlgorithm::Wilson
+	};
+	bool bConsistent = true;
+	for (MazeCore::EMazeGenAlgorithm algorithm : algorithms)
+	{
+		MazeCore::FMazeGrid grid;
+		MazeCore::GenerateMazeFromSeed(grid, size, size, algorithm, uint64_t(size));
+		MazeCore::FMazeSolver solver;
+		solver.Init(grid);
+		MazeCore::FMazeCorridorGraph graph;
+
+		auto start = std::chrono::steady_clock::now();
+		graph.Build(grid);
+		const double buildTime = SecondsSince(start);
+
+		// The same random queries on both, A* then distance fields
+		const int32_t queryCount = 20;
+		std::vector<int32_t> queries;
+		MazeCore::FMazeRandom random(3);
+		for (int32_t i = 0; i < queryCount * 4; i++) {
+			queries.push_back(random.RandRange(0, size - 1));
+		}
+
+		std::vector<int32_t> gridSteps;
+		std::vector<int32_t> path;
+		start = std::chrono::steady_clock::now();
+		for (int32_t i = 0; i < queryCount; i++) {
+			const int32_t* query = &queries[size_t(i) * 4];
+			gridSteps.push_back(solver.FindPath(query[0], query[1], query[2], query[3], path));
+		}
+		const double gridTime = SecondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		for (int32_t i = 0; i < queryCount; i++) {
+			const int32_t* query = &queries[size_t(i) * 4];
+			bConsistent = graph.FindPath(query[0], query[1], query[2], query[3], path) == gridSteps[i] && bConsistent;
+		}
+		const double graphTime = SecondsSince(start);
+
+		const char* name = MazeCore::GetAlgorithmName(algorithm);
+		const double graphMB = graph.GetAllocatedSize() / (1024.0 * 1024.0);
+		std::printf("%-22s %5d x %-5d %10d %10d %10.2f %10.1f %12.1f %12.1f\n", name, size, size, graph.GetNodeCount(),
+			graph.GetEdgeCount(), buildTime * 1000.0, graphMB, gridTime * 1.0e6 / queryCount, graphTime * 1.0e6 / queryCount);
+
+		start = std::chrono::steady_clock::now();
+		for (int32_t i = 0; i < queryCount; i++) {
+			solver.ComputeDistanceField(queries[size_t(i) * 4], queries[size_t(i) * 4 + 1]);
+		}
+		const double gridFieldTime = SecondsSince(start);
+		start = std::chrono::steady_clock::now();
+		for (int32_t i = 0; i < queryCount; i++) {
+			graph.ComputeDistanceField(queries[size_t(i) * 4], queries[size_t(i) * 4 + 1]);
+		}
+		const double graphFieldTime = SecondsSince(start);
+		std::printf("%-22s %5d x %-5d %10s %10s %10s %10s %12.1f %12.1f\n", "  distance-field", size, size, "", "", "", "",
+			gridFieldTime * 1.0e6 / queryCount, graphFieldTime * 1.0e6 / queryCount);
+
+		// Both fields are from the last query's source: compare every cell and check graph paths cell by cell
+		for (int32_t y = 0; y < size && bConsistent; y++) {
+			for (int32_t x = 0; x < size; x++) {
+				bConsistent = bConsistent && graph.GetDistance(x, y) == solver.GetDistance(x, y);
+			}
+		}
+		for (int32_t i = 0; i < queryCount && bConsistent; i++)
+		{
+			const int32_t* query = &queries[size_t(i) * 4];
+			const int32_t steps = graph.FindPath(query[0], query[1], query[2], query[3], path);
+			bConsistent = int32_t(path.size()) == steps + 1
+				&& IsValidPath(grid, path, grid.GetCellIndex(query[0], query[1]), grid.GetCellIndex(query[2], query[3]));
+		}
+
+		// A wall closed after the build cuts a corridor the graph still has. The query may fail, but must
+		// never hand back a path with holes in it.
+		const int32_t* query = &queries[size_t(queryCount - 1) * 4];
+		graph.FindPath(query[0], query[1], query[2], query[3], path);
+		if (path.size() > 2)
+		{
+			const int32_t cell = path[path.size() / 2];
+			const int32_t next = path[path.size() / 2 + 1];
+			const int32_t x = cell % size;
+			const int32_t y = cell / size;
+			if (next == cell - 1) {
+				grid.SetWestWall(x, y, true);
+			}
+			else if (next == cell + 1) {
+				grid.SetEastWall(x, y, true);
+			}
+			else if (next < cell) {
+				grid.SetSouthWall(x, y, true);
+			}
+			else {
+				grid.SetNorthWall(x, y, true);
+			}
+			const int32_t staleSteps = graph.FindPath(query[0], query[1], query[2], query[3], path);
+			bConsistent = bConsistent && (staleSteps < 0 ? path.empty() : std::find(path.begin(), path.end(), -1) == path.end());
+		}
+	}
+	if (!bConsistent) {
+		std::printf("corridor graph and grid solver DISAGREE\n");
+	}
+	return bConsistent;
+}
+
+/*===================
+BenchTreeIndex
+
+Times building the tree index and a million distance and on-path queries between random cells,
+against answering distance queries with a breadth-first search each. Returns false if the
+index disagrees with the searches.
+===================*/
+static bool BenchTreeIndex(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %12s %12s\n", "tree-index", "size", "queries", "ms", "ns/query");
+
+	MazeCore::FMazeGrid grid;
+	MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+	MazeCore::FMazeTreeIndex index;
+	auto start = std::chrono::steady_clock::now();
+	bool bConsistent = index.Build(grid);
+	std::printf("%-22s %5d x %-5d %10d %12.2f %12s  (%.1f MB)\n", "build", size, size, 1, SecondsSince(start) * 1000.0, "",
+		index.GetAllocatedSize() / (1024.0 * 1024.0));
+
+	MazeCore::FMazeRandom random(4);
+	std::vector<int32_t> cells(size_t(1) << 16);
+	for (int32_t& cell : cells) {
+		cell = random.RandRange(0, size * size - 1);
+	}
+
+	const int32_t queryCount = 1000000;
+	const size_t mask = cells.size() - 1;
+	int64_t checksum = 0;
+	start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < queryCount; i++) {
+		const int32_t a = cells[size_t(i) & mask];
+		const int32_t b = cells[size_t(i + 1) & mask];
+		checksum += index.GetDistance(a % size, a / size, b % size, b / size);
+	}
+	double elapsed = SecondsSince(start);
+	std::printf("%-22s %5d x %-5d %10d %12.2f %12.1f\n", "distance", size, size, queryCount, elapsed * 1000.0, elapsed * 1.0e9 / queryCount);
+
+	start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < queryCount; i++) {
+		const int32_t cell = cells[size_t(i) & mask];
+		const int32_t a = cells[size_t(i + 1) & mask];
+		const int32_t b = cells[size_t(i + 2) & mask];
+		checksum += index.IsOnPath(cell % size, cell / size, a % size, a / size, b % size, b / size) ? 1 : 0;
+	}
+	elapsed = SecondsSince(start);
+	std::printf("%-22s %5d x %-5d %10d %12.2f %12.1f\n", "on-path", size, size, queryCount, elapsed * 1000.0, elapsed * 1.0e9 / queryCount);
+
+	// A breadth-first search per query, checked against the index
+	MazeCore::FMazeSolver solver;
+	solver.Init(grid);
+	const int32_t searchCount = 5;
+	start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < searchCount; i++)
+	{
+		const int32_t a = cells[size_t(i)];
+		const int32_t b = cells[size_t(i + 1)];
+		solver.ComputeDistanceField(a % size, a / size);
+		bConsistent = bConsistent && solver.GetDistance(b % size, b / size) == index.GetDistance(a % size, a / size, b % size, b / size);
+	}
+	elapsed = SecondsSince(start);
+	std::printf("%-22s %5d x %-5d %10d %12.2f %12.1f  (checksum %lld)\n", "bfs", size, size, searchCount, elapsed * 1000.0,
+		elapsed * 1.0e9 / searchCount, (long long)checksum);
+
+	if (!bConsistent) {
+		std::printf("tree index and breadth-first search DISAGREE\n");
+	}
+	return bConsistent;
+}
+
+/*===================
+BenchMazeFile
+
+Saves a maze to a file and loads it back, memory-mapped where the platform allows it, with and
+without the hash check, and streams Eller mazes into files without a grid. Returns false if the
+loaded walls differ from the saved ones, a streamed file differs from a saved one, or a corrupt
+file is accepted or changes the grid it was read into.
+===================*/
+static bool BenchMazeFile(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %12s\n", "maze-file", "size", "MB", "ms");
+
+	MazeCore::FMazeGrid grid;
+	const MazeCore::FMazeEndpoints endpoints = MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+	const MazeCore::FMazeFileHeader header = MazeCore::MakeMazeFileHeader(grid, uint64_t(size), MazeCore::EMazeGenAlgorithm::IterativeBacktracker, endpoints);
+	const size_t fileSize = MazeCore::GetMazeFileSize(header);
+	const double fileMB = fileSize / (1024.0 * 1024.0);
+	const char* path = "MazeBench.maze";
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<uint8_t> data(fileSize);
+	MazeCore::WriteMazeFile(grid, header, data.data());
+	FILE* file = std::fopen(path, "wb");
+	const bool bWritten = file != nullptr && std::fwrite(data.data(), 1, fileSize, file) == fileSize;
+	if (file != nullptr) {
+		std::fclose(file);
+	}
+	std::printf("%-22s %5d x %-5d %10.1f %12.2f\n", "save", size, size, fileMB, SecondsSince(start) * 1000.0);
+	data.clear();
+	data.shrink_to_fit();
+
+	bool bMatches = bWritten;
+	for (int32_t pass = 0; pass < 2 && bMatches; pass++)
+	{
+		const bool bVerifyHash = pass == 1;
+		MazeCore::FMazeGrid loaded;
+		MazeCore::FMazeFileHeader loadedHeader;
+		start = std::chrono::steady_clock::now();
+#if defined(_WIN32)
+		file = std::fopen(path, "rb");
+		data.resize(fileSize);
+		const bool bRead = file != nullptr && std::fread(data.data(), 1, fileSize, file) == fileSize;
+		if (file != nullptr) {
+			std::fclose(file);
+		}
+		bMatches = bRead && MazeCore::ReadMazeFile(data.data(), fileSize, loaded, loadedHeader, bVerifyHash);
+#else
+		const int descriptor = open(path, O_RDONLY);
+		void* mapping = descriptor >= 0 ? mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+		bMatches = mapping != MAP_FAILED && MazeCore::ReadMazeFile(static_cast<const uint8_t*>(mapping), fileSize, loaded, loadedHeader, bVerifyHash);
+		if (mapping != MAP_FAILED) {
+			munmap(mapping, fileSize);
+		}
+		if (descriptor >= 0) {
+			close(descriptor);
+		}
+#endif
+		std::printf("%-22s %5d x %-5d %10.1f %12.2f\n", bVerifyHash ? "load+verify" : "load", size, size, fileMB, SecondsSince(start) * 1000.0);
+		bMatches = bMatches && loaded.ComputeWallHash() == grid.ComputeWallHash() && loadedHeader.exitX == endpoints.exitX
+			&& loadedHeader.exitY == endpoints.exitY;
+	}
+	std::remove(path);
+
+	// An Eller maze streamed into a file a section at a time is the same file as one written from a
+	// whole grid. Odd sizes and sections, and both exit edges, cover the padding and partial sections.
+	bool bStreamMatches = true;
+	for (uint64_t seed = 0; seed < 4; seed++)
+	{
+		const int32_t width = size + 3 + int32_t(seed);
+		const int32_t height = size / 2 + 1;
+		const int32_t sectionRows = 7 + int32_t(seed) * 50;
+		MazeCore::FMazeGrid ellerGrid;
+		const MazeCore::FMazeEndpoints ellerEndpoints = MazeCore::GenerateMazeFromSeed(ellerGrid, width, height, MazeCore::EMazeGenAlgorithm::Eller, seed);
+		const MazeCore::FMazeFileHeader ellerHeader = MazeCore::MakeMazeFileHeader(ellerGrid, seed, MazeCore::EMazeGenAlgorithm::Eller, ellerEndpoints, sectionRows);
+		std::vector<uint8_t> expected(MazeCore::GetMazeFileSize(ellerHeader));
+		MazeCore::WriteMazeFile(ellerGrid, ellerHeader, expected.data());
+		ellerGrid = MazeCore::FMazeGrid();
+
+		std::vector<uint8_t> streamed;
+		MazeCore::FMazeFileHeader streamedHeader;
+		start = std::chrono::steady_clock::now();
+		const bool bStreamed = MazeCore::StreamEllerMazeFile(width, height, seed,
+			[&streamed](size_t offset, const uint8_t* bytes, size_t byteCount)
+			{
+				streamed.resize(std::max(streamed.size(), offset + byteCount));
+				std::memcpy(streamed.data() + offset, bytes, byteCount);
+				return true;
+			}, streamedHeader, sectionRows);
+		if (seed == 0) {
+			std::printf("%-22s %5d x %-5d %10.1f %12.2f\n", "eller-stream-save", width, height, streamed.size() / (1024.0 * 1024.0), SecondsSince(start) * 1000.0);
+		}
+		bStreamMatches = bStreamMatches && bStreamed && streamed == expected;
+	}
+
+	// Headers whose size or openings fall outside the grid are refused before anything is read
+	bool bRejectsCorrupt = true;
+	for (int32_t corruption = 0; corruption < 3; corruption++)
+	{
+		MazeCore::FMazeFileHeader corrupt = header;
+		if (corruption == 0) {
+			corrupt.exitX = header.width;
+		}
+		else if (corruption == 1) {
+			corrupt.startY = -1;
+		}
+		else
+		{
+			corrupt.width = 1;
+			corrupt.height = INT32_MAX;
+		}
+		// Only the header is read, and the size claims a whole file so that only the header checks can refuse it
+		MazeCore::FMazeFileHeader loadedHeader;
+		bRejectsCorrupt = bRejectsCorrupt && !MazeCore::ReadMazeFileHeader(reinterpret_cast<const uint8_t*>(&corrupt), sizeof(corrupt) + fileSize, loadedHeader);
+	}
+
+	// A file whose walls do not match its hash is refused without touching the grid it was read into
+	bool bKeepsGrid = true;
+	{
+		std::vector<uint8_t> corruptFile(fileSize);
+		MazeCore::WriteMazeFile(grid, header, corruptFile.data());
+		corruptFile[sizeof(MazeCore::FMazeFileHeader)] ^= 1;
+		MazeCore::FMazeGrid kept;
+		MazeCore::GenerateMazeFromSeed(kept, 5, 3, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, 1);
+		const uint64_t keptHash = kept.ComputeWallHash();
+		MazeCore::FMazeFileHeader loadedHeader;
+		bKeepsGrid = !MazeCore::ReadMazeFile(corruptFile.data(), fileSize, kept, loadedHeader, true) && kept.GetWidth() == 5
+			&& kept.ComputeWallHash() == keptHash;
+	}
+
+	if (!bMatches) {
+		std::printf("maze file round trip FAILED\n");
+	}
+	if (!bStreamMatches) {
+		std::printf("streamed Eller maze file DIFFERS from one written from a grid\n");
+	}
+	if (!bRejectsCorrupt) {
+		std::printf("maze file header with openings outside the grid was ACCEPTED\n");
+	}
+	if (!bKeepsGrid) {
+		std::printf("maze file with a wrong hash CHANGED the grid it was read into\n");
+	}
+	return bMatches && bStreamMatches && bRejectsCorrupt && bKeepsGrid;
+}
+
+/*===================
+BenchLayout
+
+Times the floor and wall layout with per-edge walls and with merged wall runs, and the turn
+maze's layout, and reports how many instances each produces.
+===================*/
+static void BenchLayout(int32_t minSize, int32_t maxSize, int32_t repeat, std::vector<FBenchResult>& results)
+{
+	std::printf("\n%-22s %11s %10s %12s %10s %10s %14s %14s\n", "layout", "size", "ms", "Mcells/s", "allocs", "alloc MB", "wall instances",
+		"all instances");
+
+	for (int32_t size = minSize; size <= maxSize; size *= 2)
+	{
+		MazeCore::FMazeGrid grid;
+		MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+
+		for (const bool bMerge : { false, true }) {
+			MazeCore::FMazeLayoutSettings settings;
+			settings.bMergeWalls = bMerge;
+			MazeCore::FMazeLayout layout;
+
+			const char* name = bMerge ? "merged-walls" : "per-edge-walls";
+			const FBenchResult result = Measure((std::string("layout/") + name).c_str(), size, repeat,
+				[&]() { layout = MazeCore::FMazeLayout(); },
+				[&]() { MazeCore::BuildMazeLayout(grid, settings, layout); });
+			results.push_back(result);
+
+			std::printf("%-22s %5d x %-5d %10.2f %12.2f %10llu %10.2f %14zu %14zu\n", name, size, size, result.ms, result.mcellsPerSec,
+				(unsigned long long)result.allocations, result.allocatedMB, layout.horizontalWalls.size() + layout.verticalWalls.size(),
+				layout.GetInstanceCount());
+		}
+
+		MazeCore::FMazeTurnGrid turnGrid;
+		turnGrid.Init(size, size);
+		MazeCore::FMazeRandom random;
+		random.Seed(uint64_t(size));
+		MazeCore::GenerateTurnMaze(turnGrid, random);
+		const MazeCore::FMazeLayoutSettings settings;
+		MazeCore::FMazeLayout layout;
+		const FBenchResult result = Measure("layout/turn", size, repeat,
+			[&]() { layout = MazeCore::FMazeLayout(); },
+			[&]() { MazeCore::BuildTurnMazeLayout(turnGrid, settings, layout); });
+		results.push_back(result);
+
+		std::printf("%-22s %5d x %-5d %10.2f %12.2f %10llu %10.2f %14zu %14zu\n", "turn", size, size, result.ms, result.mcellsPerSec,
+			(unsigned long long)result.allocations, result.allocatedMB, layout.horizontalWalls.size() + layout.verticalWalls.size(),
+			layout.GetInstanceCount());
+	}
+}
+
+/*===================
+WriteResults
+
+Writes the suite as JSON, one result per line, which is also the layout ReadResults expects
+===================*/
+static bool WriteResults(const char* path, const std::vector<FBenchResult>& results)
+{
+	FILE* file = std::fopen(path, "w");
+	if (!file) {
+		std::printf("could not write %s\n", path);
+		return false;
+	}
+	std::fprintf(file, "{\n\t\"version\": 2,\n\t\"results\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const FBenchResult& result = results[i];
+		std::fprintf(file, "\t\t{\"name\": \"%s\", \"size\": %d, \"ms\": %.4f, \"mcellsPerSec\": %.4f, \"allocations\": %llu, "
+			"\"allocatedMB\": %.4f, \"residentMB\": %.1f}%s\n", result.name.c_str(), result.size, result.ms, result.mcellsPerSec,
+			(unsigned long long)result.allocations, result.allocatedMB, result.residentMB, i + 1 < results.size() ? "," : "");
+	}
+	std::fprintf(file, "\t]\n}\n");
+	std::fclose(file);
+	std::printf("\nwrote %zu results to %s\n", results.size(), path);
+	return true;
+}
+
+/*===================
+ReadResults
+
+Reads a baseline written by WriteResults. Lines that are not a result are skipped. The memory
+figure is not compared, so baselines from before it was per measurement still load.
+===================*/
+static bool ReadResults(const char* path, std::vector<FBenchResult>& outResults)
+{
+	FILE* file = std::fopen(path, "r");
+	if (!file) {
+		std::printf("could not read baseline %s\n", path);
+		return false;
+	}
+	char line[512];
+	while (std::fgets(line, sizeof(line), file))
+	{
+		char name[128];
+		FBenchResult result;
+		unsigned long long allocations = 0;
+		if (std::sscanf(line, " {\"name\": \"%127[^\"]\", \"size\": %d, \"ms\": %lf, \"mcellsPerSec\": %lf, \"allocations\": %llu, "
+			"\"allocatedMB\": %lf", name, &result.size, &result.ms, &result.mcellsPerSec, &allocations, &result.allocatedMB) == 6)
+		{
+			result.name = name;
+			result.allocations = allocations;
+			outResults.push_back(result);
+		}
+	}
+	std::fclose(file);
+	return true;
+}
+
+/*===================
+CompareResults
+
+Checks every result against the baseline entry with the same name and size. A result regresses
+when it is slower, or makes more allocations, by more than the threshold. Short runs are timed
+over batches (see Measure), so every result is compared; only a handful of extra allocations
+is not counted. Returns false on any regression.
+===================*/
+static bool CompareResults(const std::vector<FBenchResult>& results, const std::vector<FBenchResult>& baseline, double thresholdPercent)
+{
+	static const uint64_t AllocationSlack = 16;
+
+	std::printf("\n%-32s %11s %12s %12s %9s %12s %12s  %s\n", "baseline", "size", "base ms", "ms", "change", "base allocs", "allocs", "status");
+
+	const double limit = 1.0 + thresholdPercent / 100.0;
+	int32_t regressionCount = 0;
+	for (const FBenchResult& result : results)
+	{
+		const auto found = std::find_if(baseline.begin(), baseline.end(), [&result](const FBenchResult& base)
+		{
+			return base.name == result.name && base.size == result.size;
+		});
+		if (found == baseline.end())
+		{
+			std::printf("%-32s %5d x %-5d %12s %12.2f %9s %12s %12llu  new\n", result.name.c_str(), result.size, result.size, "-", result.ms, "-", "-",
+				(unsigned long long)result.allocations);
+			continue;
+		}
+
+		const bool bSlower = result.ms > found->ms * limit;
+		const bool bMoreAllocations = result.allocations > found->allocations + AllocationSlack && double(result.allocations) > double(found->allocations) * limit;
+		const char* status = bSlower ? (bMoreAllocations ? "SLOWER, MORE ALLOCATIONS" : "SLOWER") : (bMoreAllocations ? "MORE ALLOCATIONS" : "ok");
+		if (bSlower || bMoreAllocations) {
+			regressionCount++;
+		}
+		std::printf("%-32s %5d x %-5d %12.2f %12.2f %8.1f%% %12llu %12llu  %s\n", result.name.c_str(), result.size, result.size, found->ms, result.ms,
+			(result.ms / found->ms - 1.0) * 100.0, (unsigned long long)found->allocations, (unsigned long long)result.allocations, status);
+	}
+
+	if (regressionCount > 0) {
+		std::printf("%d results regressed by more than %.1f%%\n", regressionCount, thresholdPercent);
+	}
+	return regressionCount == 0;
+}
+
+/*===================
+SortedRuns
+
+Runs of a wall instance map ordered by line and start, to compare maps built in different orders.
+===================*/
+static std::vector<MazeCore::FMazeWallRun> SortedRuns(const MazeCore::FMazeWallInstances& walls)
+{
+	std::vector<MazeCore::FMazeWallRun> runs;
+	for (int32_t i = 0; i < walls.GetInstanceCount(); i++) {
+		runs.push_back(walls.GetInstanceRun(i));
+	}
+	std::sort(runs.begin(), runs.end(), [](const MazeCore::FMazeWallRun& a, const MazeCore::FMazeWallRun& b)
+	{
+		return a.line != b.line ? a.line < b.line : a.start < b.start;
+	});
+	return runs;
+}
+
+static bool IsSameRun(const MazeCore::FMazeWallRun& a, const MazeCore::FMazeWallRun& b)
+{
+	return a.line == b.line && a.start == b.start && a.length == b.length;
+}
+
+/*===================
+BenchWallEdits
+
+Toggles random walls and flushes every 100 edits into a copy of the instance list, applied the
+way a mesh component is: dirty instances rewritten, the tail removed, new instances appended.
+Checks that the instances start out identical to the layout's, that the copy always matches the
+map, and that the runs after all edits are the runs a fresh build of the edited grid gives.
+===================*/
+static bool BenchWallEdits(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %12s %12s %14s\n", "wall-edits", "size", "edits", "ms", "ns/edit", "changes/flush");
+
+	bool bConsistent = true;
+	for (const bool bMerge : { false, true })
+	{
+		MazeCore::FMazeGrid grid;
+		MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+		MazeCore::FMazeLayoutSettings settings;
+		settings.bMergeWalls = bMerge;
+		MazeCore::FMazeLayout layout;
+		MazeCore::BuildMazeLayout(grid, settings, layout);
+
+		MazeCore::FMazeWallInstances walls[2];
+		walls[0].Build(grid, true, bMerge);
+		walls[1].Build(grid, false, bMerge);
+
+		// Stand-ins for the default and rotated wall components
+		std::vector<MazeCore::FMazeWallRun> components[2];
+		for (int32_t side = 0; side < 2; side++)
+		{
+			const std::vector<MazeCore::FMazeInstance>& placed = side == 0 ? layout.horizontalWalls : layout.verticalWalls;
+			bConsistent = bConsistent && int32_t(placed.size()) == walls[side].GetInstanceCount();
+			for (int32_t i = 0; i < walls[side].GetInstanceCount(); i++)
+			{
+				const MazeCore::FMazeWallRun& run = walls[side].GetInstanceRun(i);
+				const MazeCore::FMazeInstance instance = MazeCore::MakeWallInstance(side == 0, run.line, run.start, run.length, settings);
+				bConsistent = bConsistent && std::memcmp(&instance, &placed[size_t(i)], sizeof(instance)) == 0;
+				components[side].push_back(run);
+			}
+		}
+
+		MazeCore::FMazeRandom random(uint64_t(size) + (bMerge ? 1 : 0));
+		const int32_t editCount = 200000;
+		const int32_t flushInterval = 100;
+		int64_t changes = 0;
+		double editSeconds = 0.0;
+		for (int32_t flush = 0; flush < editCount / flushInterval; flush++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (int32_t i = 0; i < flushInterval; i++)
+			{
+				const int32_t side = random.RandRange(0, 1);
+				const int32_t line = random.RandRange(0, size);
+				const int32_t position = random.RandRange(0, size - 1);
+				const bool bWall = !walls[side].HasWall(line, position);
+				walls[side].SetWall(line, position, bWall);
+				if (side == 0) {
+					grid.SetSouthWall(position, line, bWall);
+				}
+				else {
+					grid.SetWestWall(line, position, bWall);
+				}
+			}
+			editSeconds += SecondsSince(start);
+
+			for (int32_t side = 0; side < 2; side++)
+			{
+				MazeCore::FMazeWallInstances& edited = walls[side];
+				std::vector<MazeCore::FMazeWallRun>& component = components[side];
+				for (const int32_t instance : edited.GetDirtyInstances())
+				{
+					if (instance < edited.GetInstanceCount()) {
+						component[size_t(instance)] = edited.GetInstanceRun(instance);
+					}
+				}
+				component.resize(size_t(std::min(edited.GetInstanceCount(), edited.GetCommittedCount())));
+				for (int32_t instance = edited.GetCommittedCount(); instance < edited.GetInstanceCount(); instance++) {
+					component.push_back(edited.GetInstanceRun(instance));
+				}
+				changes += int64_t(edited.GetDirtyInstances().size()) + std::abs(edited.GetInstanceCount() - edited.GetCommittedCount());
+				edited.Commit();
+
+				for (int32_t instance = 0; bConsistent && instance < edited.GetInstanceCount(); instance++) {
+					bConsistent = IsSameRun(component[size_t(instance)], edited.GetInstanceRun(instance));
+				}
+			}
+		}
+
+		for (int32_t side = 0; side < 2; side++)
+		{
+			MazeCore::FMazeWallInstances rebuilt;
+			rebuilt.Build(grid, side == 0, bMerge);
+			const std::vector<MazeCore::FMazeWallRun> expected = SortedRuns(rebuilt);
+			const std::vector<MazeCore::FMazeWallRun> actual = SortedRuns(walls[side]);
+			bConsistent = bConsistent && expected.size() == actual.size()
+				&& std::equal(expected.begin(), expected.end(), actual.begin(), IsSameRun);
+		}
+
+		std::printf("%-22s %5d x %-5d %10d %12.2f %12.1f %14.1f  (%.1f MB)\n", bMerge ? "merged-walls" : "per-edge-walls", size, size,
+			editCount, editSeconds * 1000.0, editSeconds * 1.0e9 / editCount, double(changes) / (editCount / flushInterval),
+			(walls[0].GetAllocatedSize() + walls[1].GetAllocatedSize()) / (1024.0 * 1024.0));
+	}
+
+	if (!bConsistent) {
+		std::printf("wall instances and layout DISAGREE\n");
+	}
+	return bConsistent;
+}
+
+/*===================
+BenchRegionShuffle
+
+Shuffles random regions of a maze in slices of 4096 cells of work, the way the actor spreads a
+shuffle over frames, and applies the changed walls to wall instance maps. Reports the longest
+slice, Start included, which is what a frame pays. Returns false if a shuffle left the maze imperfect or the
+maps differ from a fresh build of the shuffled grid.
+===================*/
+static bool BenchRegionShuffle(int32_t size)
+{
+	std::printf("\n%-22s %11s %10s %10s %12s %12s %12s %12s\n", "region-shuffle", "size", "region", "shuffles", "ms/shuffle",
+		"slices", "max slice ms", "walls/shuffle");
+
+	MazeCore::FMazeGrid grid;
+	MazeCore::GenerateMazeFromSeed(grid, size, size, MazeCore::EMazeGenAlgorithm::IterativeBacktracker, uint64_t(size));
+	MazeCore::FMazeWallInstances walls[2];
+	walls[0].Build(grid, true, true);
+	walls[1].Build(grid, false, true);
+
+	MazeCore::FMazeRegionShuffle shuffle;
+	shuffle.Reserve(grid);
+	MazeCore::FMazeRandom random(7);
+	const int32_t sliceWork = 4096;
+	const int32_t shuffleCount = 8;
+	bool bConsistent = true;
+	for (const int32_t regionSize : { 16, 64, 256 })
+	{
+		double totalSeconds = 0.0;
+		double maxSliceSeconds = 0.0;
+		int64_t slices = 0;
+		int64_t changedWalls = 0;
+		for (int32_t i = 0; i < shuffleCount; i++)
+		{
+			const int32_t minX = random.RandRange(0, std::max(0, size - regionSize));
+			const int32_t minY = random.RandRange(0, std::max(0, size - regionSize));
+			// Start runs in the first slice, as it does in the frame that asks for the shuffle
+			auto start = std::chrono::steady_clock::now();
+			shuffle.Start(grid, minX, minY, regionSize, regionSize, random.Next());
+
+			bool bDone = false;
+			for (bool bFirst = true; !bDone; bFirst = false)
+			{
+				if (!bFirst) {
+					start = std::chrono::steady_clock::now();
+				}
+				bDone = shuffle.Advance(grid, sliceWork);
+				const double elapsed = SecondsSince(start);
+				totalSeconds += elapsed;
+				maxSliceSeconds = std::max(maxSliceSeconds, elapsed);
+				slices++;
+			}
+
+			for (const MazeCore::FMazeWallEdge& edge : shuffle.GetChangedWalls())
+			{
+				const bool bWall = edge.bHorizontal ? grid.HasHorizontalWall(edge.position, edge.line) : grid.HasVerticalWall(edge.line, edge.position);
+				walls[edge.bHorizontal ? 0 : 1].SetWall(edge.line, edge.position, bWall);
+			}
+			changedWalls += int64_t(shuffle.GetChangedWalls().size());
+			bConsistent = bConsistent && MazeCore::IsPerfectMaze(grid);
+		}
+		std::printf("%-22s %5d x %-5d %4d x %-4d %10d %12.2f %12.1f %12.3f %12.1f\n", "backtracker", size, size, regionSize, regionSize,
+			shuffleCount, totalSeconds * 1000.0 / shuffleCount, double(slices) / shuffleCount, maxSliceSeconds * 1000.0,
+			double(changedWalls) / shuffleCount);
+	}
+
+	for (int32_t side = 0; side < 2; side++)
+	{
+		MazeCore::FMazeWallInstances rebuilt;
+		rebuilt.Build(grid, side == 0, true);
+		const std::vector<MazeCore::FMazeWallRun> expected = SortedRuns(rebuilt);
+		const std::vector<MazeCore::FMazeWallRun> actual = SortedRuns(walls[side]);
+		bConsistent = bConsistent && expected.size() == actual.size()
+			&& std::equal(expected.begin(), expected.end(), actual.begin(), IsSameRun);
+	}
+
+	if (!bConsistent) {
+		std::printf("region shuffle left the maze NOT PERFECT or the wall instances out of step\n");
+	}
+	return bConsistent;
+}
+
+int main(int argc, char** argv)
+{
+	int32_t minSize = 64;
+	int32_t maxSize = 8192;
+	int32_t repeat = 1;
+	bool bVerify = false;
+	const char* jsonPath = nullptr;
+	const char* baselinePath = nullptr;
+	double thresholdPercent = 15.0;
+
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--min") == 0 && i + 1 < argc) {
+			minSize = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+			maxSize = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--verify") == 0) {
+			bVerify = true;
+		}
+		else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+			repeat = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			jsonPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+			baselinePath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+			thresholdPercent = std::atof(argv[++i]);
+		}
+		else {
+			std::printf("Usage: MazeBench [--min N] [--max N] [--verify] [--repeat N] [--json FILE] [--baseline FILE] [--threshold PERCENT]\n");
+			return 1;
+		}
+	}
+
+	// Read the baseline first, so a missing file fails before the long run rather than after it
+	std::vector<FBenchResult> baseline;
+	if (baselinePath && !ReadResults(baselinePath, baseline)) {
+		return 1;
+	}
+
+	std::vector<FBenchResult> results;
+	const bool bAllPerfect = BenchGeneration(minSize, maxSize, repeat, bVerify, results);
+	const bool bDeterministic = BenchParallelScaling(maxSize);
+	BenchEllerStreaming(maxSize);
+	const bool bSolverConsistent = BenchSolver(std::min(maxSize, 1024));
+	const bool bFlowFieldConsistent = BenchFlowField(std::min(maxSize, 1024));
+	const bool bCorridorGraphConsistent = BenchCorridorGraph(std::min(maxSize, 1024));
+	const bool bTreeIndexConsistent = BenchTreeIndex(std::min(maxSize, 4096));
+	const bool bMazeFileRoundTrips = BenchMazeFile(maxSize);
+	BenchLayout(minSize, maxSize, repeat, results);
+	const bool bWallEditsConsistent = BenchWallEdits(std::min(maxSize, 1024));
+	const bool bRegionShufflePerfect = BenchRegionShuffle(std::min(maxSize, 2048));
+
+	const bool bWritten = !jsonPath || WriteResults(jsonPath, results);
+	const bool bNoRegressions = !baselinePath || CompareResults(results, baseline, thresholdPercent);
+	return bAllPerfect && bDeterministic && bSolverConsistent && bFlowFieldConsistent && bCorridorGraphConsistent && bTreeIndexConsistent
+		&& bMazeFileRoundTrips && bWallEditsConsistent && bRegionShufflePerfect && bWritten && bNoRegressions ? 0 : 1;
+}